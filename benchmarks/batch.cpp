@@ -0,0 +1,102 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Vladislav Trifochkin
+//
+// License: see LICENSE file
+//
+// This file is part of `modulus2-lib`.
+//
+// Changelog:
+//      2026.10.17 Initial version.
+////////////////////////////////////////////////////////////////////////////////
+#include "pfs/modulus/modulus.hpp"
+#include "pfs/modulus/iostream_logger.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <list>
+#include <thread>
+#include <vector>
+
+// Producer emits events to 4 queued detectors, each queue is consumed by its
+// own thread. Events are emitted one by one (emitter_type<int>) and in
+// batches of different size (batch_emitter<int>).
+
+using modulus_t = modulus::modulus<modulus::iostream_logger, modulus::null_settings>;
+
+constexpr int subscriber_count = 4;
+constexpr int total_events = 1 << 20;
+
+struct subscriber
+{
+    std::atomic<long> received {0};
+
+    void on_event (int) { received.fetch_add(1, std::memory_order_relaxed); }
+
+    void on_batch (modulus::batch<int> events)
+    {
+        received.fetch_add(static_cast<long>(events.size()), std::memory_order_relaxed);
+    }
+};
+
+template <typename Emitter, typename Emit, typename Detector>
+double run (Emit emit, Detector detector)
+{
+    Emitter em;
+    std::list<modulus_t::function_queue_type> queues;
+    std::vector<subscriber> subscribers(subscriber_count);
+    std::vector<std::thread> consumers;
+
+    for (auto & s: subscribers) {
+        queues.emplace_back();
+        auto & q = queues.back();
+        em.connect(q, s, detector);
+
+        consumers.emplace_back([& q, & s] {
+            while (s.received.load(std::memory_order_relaxed) < total_events) {
+                q.wait_for(1000);
+                q.call_all();
+            }
+        });
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    emit(em);
+
+    for (auto & t: consumers)
+        t.join();
+
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    // Million events per second
+    return total_events / std::chrono::duration<double, std::micro>(elapsed).count();
+}
+
+int main ()
+{
+    std::printf("%-10s %14s\n", "batch", "Mevents/s");
+
+    auto single = run<modulus_t::emitter_type<int>>([] (modulus_t::emitter_type<int> & em) {
+        for (int i = 0; i < total_events; i++)
+            em(i);
+    }, & subscriber::on_event);
+
+    std::printf("%-10s %14.2f\n", "none", single);
+
+    for (int batch_size: {1, 16, 256, 4096}) {
+        auto r = run<modulus_t::batch_emitter<int>>([batch_size] (modulus_t::batch_emitter<int> & em) {
+            std::vector<int> events(batch_size);
+
+            for (int i = 0; i < total_events; i += batch_size) {
+                for (int j = 0; j < batch_size; j++)
+                    events[j] = i + j;
+
+                em.emit_batch(events.begin(), events.end());
+            }
+        }, & subscriber::on_batch);
+
+        std::printf("%-10d %14.2f\n", batch_size, r);
+    }
+
+    return 0;
+}
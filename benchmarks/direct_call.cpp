@@ -0,0 +1,139 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Vladislav Trifochkin
+//
+// License: see LICENSE file
+//
+// This file is part of `modulus2-lib`.
+//
+// Changelog:
+//      2026.10.17 Initial version.
+////////////////////////////////////////////////////////////////////////////////
+#include "pfs/modulus/modulus.hpp"
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+// Ping-pong between runnable module and its guest: each round is the queued
+// step emitting ping, the guest answers with ack, ack detector queues the next
+// step. Detectors are connected in connection_mode::queued and
+// connection_mode::direct modes.
+
+class null_logger
+{
+public:
+    void t (std::string const &) {}
+    void d (std::string const &) {}
+    void i (std::string const &) {}
+    void w (std::string const &) {}
+    void e (std::string const &) {}
+};
+
+using modulus_t = modulus::modulus<null_logger, modulus::null_settings>;
+
+constexpr int round_count = 200000;
+
+static modulus::connection_mode __mode {modulus::connection_mode::queued};
+static std::chrono::steady_clock::duration __elapsed;
+
+class ping_module : public modulus_t::runnable_module
+{
+    modulus_t::emitter_type<int> emitPing;
+    int _round {0};
+    std::chrono::steady_clock::time_point _start;
+
+private:
+    void declare_emitters (modulus_t::module_context & ctx) override
+    {
+        ctx.declare_emitter(0, emitPing);
+    }
+
+    void declare_detectors (modulus_t::module_context & ctx) override
+    {
+        ctx.declare_detector(1);
+    }
+
+    bool connect_detector (modulus_t::api_id_type id
+        , modulus_t::module_context & ctx) override
+    {
+        return id == 1 && ctx.connect_detector(id, *this, & ping_module::onAck, __mode);
+    }
+
+    bool on_start () override
+    {
+        start_timer(std::chrono::milliseconds{1}, [this] {
+            _start = std::chrono::steady_clock::now();
+            next();
+        });
+
+        return true;
+    }
+
+    void next ()
+    {
+        if (_round++ == round_count) {
+            __elapsed = std::chrono::steady_clock::now() - _start;
+            quit();
+            return;
+        }
+
+        emitPing(_round);
+    }
+
+    void onAck (int)
+    {
+        queue()->push([this] { next(); });
+    }
+};
+
+class pong_module : public modulus_t::guest_module
+{
+    modulus_t::emitter_type<int> emitAck;
+
+private:
+    void declare_emitters (modulus_t::module_context & ctx) override
+    {
+        ctx.declare_emitter(1, emitAck);
+    }
+
+    void declare_detectors (modulus_t::module_context & ctx) override
+    {
+        ctx.declare_detector(0);
+    }
+
+    bool connect_detector (modulus_t::api_id_type id
+        , modulus_t::module_context & ctx) override
+    {
+        return id == 0 && ctx.connect_detector(id, *this, & pong_module::onPing, __mode);
+    }
+
+    void onPing (int value)
+    {
+        emitAck(value);
+    }
+};
+
+double run (modulus::connection_mode mode)
+{
+    __mode = mode;
+
+    modulus_t::dispatcher d{std::make_shared<null_logger>(), modulus::null_settings{}};
+
+    d.register_module<ping_module>(std::make_pair("ping", ""));
+    d.register_module<pong_module>(std::make_pair("pong", "ping"));
+    d.exec();
+
+    return std::chrono::duration<double, std::nano>(__elapsed).count() / round_count;
+}
+
+int main ()
+{
+    auto queued = run(modulus::connection_mode::queued);
+    auto direct = run(modulus::connection_mode::direct);
+
+    std::printf("%-10s %14s\n", "mode", "ns/round");
+    std::printf("%-10s %14.1f\n", "queued", queued);
+    std::printf("%-10s %14.1f\n", "direct", direct);
+
+    return 0;
+}
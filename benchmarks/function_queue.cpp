@@ -0,0 +1,72 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Vladislav Trifochkin
+//
+// License: see LICENSE file
+//
+// This file is part of `modulus2-lib`.
+//
+// Changelog:
+//      2026.10.17 Initial version.
+////////////////////////////////////////////////////////////////////////////////
+#include "pfs/modulus/mpsc_function_queue.hpp"
+#include <pfs/function_queue.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+// Fan-in benchmark: many producer threads push into a single queue consumed
+// by one thread (as emitters do for a runnable module).
+
+constexpr int total_events = 1000000;
+
+template <typename QueueType>
+double fan_in (int producer_count)
+{
+    QueueType q;
+    std::atomic_int counter {0};
+    std::atomic_bool go {false};
+    std::vector<std::thread> producers;
+    int per_producer = total_events / producer_count;
+    int expected = per_producer * producer_count;
+
+    for (int p = 0; p < producer_count; p++) {
+        producers.emplace_back([&] {
+            while (!go)
+                std::this_thread::yield();
+
+            for (int i = 0; i < per_producer; i++)
+                q.push([& counter] { counter.fetch_add(1, std::memory_order_relaxed); });
+        });
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    go = true;
+
+    while (counter.load(std::memory_order_relaxed) < expected) {
+        q.wait_for(1000);
+        q.call_all();
+    }
+
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    for (auto & th: producers)
+        th.join();
+
+    return expected / std::chrono::duration<double>(elapsed).count();
+}
+
+int main ()
+{
+    std::printf("%-10s %22s %22s\n", "producers", "pfs::function_queue", "mpsc_function_queue");
+
+    for (int producer_count: {1, 2, 4, 8, 16}) {
+        auto a = fan_in<pfs::function_queue<>>(producer_count);
+        auto b = fan_in<modulus::mpsc_function_queue>(producer_count);
+
+        std::printf("%-10d %16.0f ops/s %16.0f ops/s\n", producer_count, a, b);
+    }
+
+    return 0;
+}
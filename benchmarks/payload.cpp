@@ -0,0 +1,134 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Vladislav Trifochkin
+//
+// License: see LICENSE file
+//
+// This file is part of `modulus2-lib`.
+//
+// Changelog:
+//      2026.10.17 Initial version.
+////////////////////////////////////////////////////////////////////////////////
+#include "pfs/modulus/modulus.hpp"
+#include "pfs/modulus/iostream_logger.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+// Emits 64 KB message to 6 queued detectors by value and as shared payload,
+// counts message copies, heap allocations and allocated bytes per emit.
+
+static std::atomic<std::size_t> __allocations {0};
+static std::atomic<std::size_t> __allocated_bytes {0};
+
+#if defined(__GNUC__)
+#   define BENCHMARK__NOINLINE __attribute__((noinline))
+#else
+#   define BENCHMARK__NOINLINE
+#endif
+
+BENCHMARK__NOINLINE void * operator new (std::size_t size)
+{
+    ++__allocations;
+    __allocated_bytes += size;
+
+    if (auto p = std::malloc(size))
+        return p;
+
+    throw std::bad_alloc{};
+}
+
+BENCHMARK__NOINLINE void operator delete (void * p) noexcept
+{
+    std::free(p);
+}
+
+BENCHMARK__NOINLINE void operator delete (void * p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+using modulus_t = modulus::modulus<modulus::iostream_logger, modulus::null_settings>;
+
+constexpr int subscriber_count = 6;
+constexpr int emit_count = 2000;
+
+struct snapshot
+{
+    static std::size_t copies;
+
+    std::vector<char> data;
+
+    snapshot (): data(64 * 1024, 'x') {}
+    snapshot (snapshot &&) = default;
+    snapshot (snapshot const & other): data(other.data) { ++copies; }
+};
+
+std::size_t snapshot::copies = 0;
+
+struct subscriber
+{
+    std::size_t bytes {0};
+
+    void on_value (snapshot s) { bytes += s.data.size(); }
+    void on_payload (modulus::payload<snapshot> s) { bytes += s->data.size(); }
+};
+
+struct result
+{
+    double copies;
+    double allocations;
+    double kbytes;
+    double us;
+};
+
+template <typename Emitter, typename Emit, typename Detector>
+result run (Emit emit, Detector detector)
+{
+    Emitter em;
+    modulus_t::function_queue_type q;
+    std::vector<subscriber> subscribers(subscriber_count);
+
+    for (auto & s: subscribers)
+        em.connect(q, s, detector);
+
+    snapshot::copies = 0;
+    auto allocations = __allocations.load();
+    auto allocated_bytes = __allocated_bytes.load();
+    auto start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < emit_count; i++) {
+        emit(em);
+        q.call_all();
+    }
+
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    result r;
+    r.copies = static_cast<double>(snapshot::copies) / emit_count;
+    r.allocations = static_cast<double>(__allocations.load() - allocations) / emit_count;
+    r.kbytes = static_cast<double>(__allocated_bytes.load() - allocated_bytes) / emit_count / 1024;
+    r.us = std::chrono::duration<double, std::micro>(elapsed).count() / emit_count;
+    return r;
+}
+
+int main ()
+{
+    auto by_value = run<modulus_t::emitter_type<snapshot>>(
+          [] (modulus_t::emitter_type<snapshot> & em) { em(snapshot{}); }
+        , & subscriber::on_value);
+
+    auto by_payload = run<modulus_t::payload_emitter<snapshot>>(
+          [] (modulus_t::payload_emitter<snapshot> & em) { em(snapshot{}); }
+        , & subscriber::on_payload);
+
+    std::printf("%-10s %12s %12s %12s %12s\n", "mode", "copies/emit", "allocs/emit", "KB/emit", "us/emit");
+    std::printf("%-10s %12.1f %12.1f %12.1f %12.2f\n", "value"
+        , by_value.copies, by_value.allocations, by_value.kbytes, by_value.us);
+    std::printf("%-10s %12.1f %12.1f %12.1f %12.2f\n", "payload"
+        , by_payload.copies, by_payload.allocations, by_payload.kbytes, by_payload.us);
+
+    return 0;
+}
@@ -0,0 +1,105 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Vladislav Trifochkin
+//
+// License: see LICENSE file
+//
+// This file is part of `modulus2-lib`.
+//
+// Changelog:
+//      2026.10.17 Initial version.
+////////////////////////////////////////////////////////////////////////////////
+#include "pfs/modulus/modulus.hpp"
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+// Module registration scaling: each module has one emitter and one detector
+// for the emitter of the previous module. Modules with declared detectors
+// are wired using API identifier index, legacy modules are scanned against
+// every registered emitter. Batch registration wires all modules in one pass
+// on commit.
+
+class null_logger
+{
+public:
+    void t (std::string const &) {}
+    void d (std::string const &) {}
+    void i (std::string const &) {}
+    void w (std::string const &) {}
+    void e (std::string const &) {}
+};
+
+using modulus_t = modulus::modulus<null_logger, modulus::null_settings>;
+
+template <bool DeclareDetectors>
+class chain_module : public modulus_t::regular_module
+{
+    int _index {0};
+    modulus_t::emitter_type<int> emitValue;
+
+private:
+    void declare_emitters (modulus_t::module_context & ctx) override
+    {
+        ctx.declare_emitter(_index, emitValue);
+    }
+
+    void declare_detectors (modulus_t::module_context & ctx) override
+    {
+        if (DeclareDetectors)
+            ctx.declare_detector(_index - 1);
+        else
+            ctx.declare_any_detector();
+    }
+
+    bool connect_detector (modulus_t::api_id_type id
+        , modulus_t::module_context & ctx) override
+    {
+        if (id == _index - 1)
+            return ctx.connect_detector(id, *this, & chain_module::onValue);
+
+        return false;
+    }
+
+    void onValue (int)
+    {}
+
+public:
+    chain_module (int index): _index(index) {}
+};
+
+template <bool DeclareDetectors>
+double register_modules (int module_count, bool batch = false)
+{
+    modulus_t::dispatcher d{std::make_shared<null_logger>(), modulus::null_settings{}};
+    auto start = std::chrono::steady_clock::now();
+
+    if (batch)
+        d.begin_batch();
+
+    for (int i = 0; i < module_count; i++) {
+        auto name = "m" + std::to_string(i);
+        d.register_module<chain_module<DeclareDetectors>>(std::make_pair(name, std::string{}), i);
+    }
+
+    if (batch)
+        d.commit_batch();
+
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::milli>(elapsed).count();
+}
+
+int main ()
+{
+    std::printf("%-10s %20s %20s %20s\n", "modules", "declared detectors", "batch", "legacy (scan)");
+
+    for (int module_count: {10, 100, 1000, 3000, 10000}) {
+        auto a = register_modules<true>(module_count);
+        auto b = register_modules<true>(module_count, true);
+        auto c = register_modules<false>(module_count);
+
+        std::printf("%-10d %17.2f ms %17.2f ms %17.2f ms\n", module_count, a, b, c);
+    }
+
+    return 0;
+}
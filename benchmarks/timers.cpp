@@ -0,0 +1,81 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Vladislav Trifochkin
+//
+// License: see LICENSE file
+//
+// This file is part of `modulus2-lib`.
+//
+// Changelog:
+//      2026.10.17 Initial version.
+////////////////////////////////////////////////////////////////////////////////
+#include "pfs/modulus/timing_wheel.hpp"
+#include <pfs/timer_pool.hpp>
+#include <chrono>
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// Arm/cancel cost with many active timers (e.g. per-connection timeouts).
+// Timers are armed with delays spread over a minute and cancelled in random
+// order before expiration.
+
+struct result
+{
+    double arm_ns;
+    double cancel_ns;
+};
+
+template <typename TimerPoolType>
+result arm_cancel (std::size_t timer_count)
+{
+    using timer_id = typename TimerPoolType::timer_id;
+
+    TimerPoolType pool;
+    std::vector<timer_id> ids;
+    std::vector<std::chrono::milliseconds> delays;
+    std::mt19937 gen {42};
+    std::uniform_int_distribution<int> dist {1000, 60000};
+
+    ids.reserve(timer_count);
+    delays.reserve(timer_count);
+
+    for (std::size_t i = 0; i < timer_count; i++)
+        delays.emplace_back(dist(gen));
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (auto delay: delays)
+        ids.push_back(pool.create(delay, [] {}));
+
+    auto armed = std::chrono::steady_clock::now();
+
+    std::shuffle(ids.begin(), ids.end(), gen);
+
+    auto cancel_start = std::chrono::steady_clock::now();
+
+    for (auto id: ids)
+        pool.destroy(id);
+
+    auto cancelled = std::chrono::steady_clock::now();
+
+    result r;
+    r.arm_ns = std::chrono::duration<double, std::nano>(armed - start).count() / timer_count;
+    r.cancel_ns = std::chrono::duration<double, std::nano>(cancelled - cancel_start).count() / timer_count;
+    return r;
+}
+
+int main ()
+{
+    std::printf("%-10s %28s %28s\n", "timers", "pfs::timer_pool (arm/cancel)", "timing_wheel (arm/cancel)");
+
+    for (std::size_t timer_count: {10000, 100000, 1000000}) {
+        auto a = arm_cancel<pfs::timer_pool>(timer_count);
+        auto b = arm_cancel<modulus::timing_wheel<pfs::timer_pool::timer_id>>(timer_count);
+
+        std::printf("%-10zu %10.0f ns %10.0f ns %10.0f ns %10.0f ns\n", timer_count
+            , a.arm_ns, a.cancel_ns, b.arm_ns, b.cancel_ns);
+    }
+
+    return 0;
+}
@@ -0,0 +1,110 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Vladislav Trifochkin
+//
+// License: see LICENSE file
+//
+// This file is part of `modulus2-lib`.
+//
+// Changelog:
+//      2026.10.17 Initial version.
+////////////////////////////////////////////////////////////////////////////////
+#include "pfs/modulus/module_queue.hpp"
+#include <pfs/function_queue.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+// Wakeup latency of the consumer (time from push to call of the action) for
+// different wait strategies. Consumer loop is the same as in the default
+// runnable_module::run(). Producer pushes actions with pause, so the consumer
+// is waiting for each of them. Spinning and yielding make sense only if the
+// consumer has dedicated CPU (see module_options::placement).
+
+using clock_type = std::chrono::steady_clock;
+using queue_type = modulus::module_queue<pfs::function_queue<>>;
+
+constexpr int sample_count = 20000;
+constexpr auto push_interval = std::chrono::microseconds{50};
+
+struct strategy
+{
+    char const * name;
+    std::chrono::microseconds spin_time;
+    std::chrono::microseconds yield_time;
+};
+
+std::vector<double> run (strategy const & s)
+{
+    queue_type q;
+    modulus::queue_options opts;
+    opts.spin_time = s.spin_time;
+    opts.yield_time = s.yield_time;
+    q.set_options(opts);
+
+    std::vector<double> latencies;
+    latencies.reserve(sample_count);
+    std::atomic<bool> finish {false};
+
+    std::thread consumer {[& q, & finish] {
+        while (!finish) {
+            q.wait();
+            q.call_all();
+        }
+    }};
+
+    for (int i = 0; i < sample_count; i++) {
+        auto deadline = clock_type::now() + push_interval;
+
+        // Busy wait: sleep granularity is too coarse
+        while (clock_type::now() < deadline)
+            modulus::cpu_relax();
+
+        q.push([& latencies] (clock_type::time_point pushed) {
+            latencies.push_back(std::chrono::duration<double, std::micro>(clock_type::now() - pushed).count());
+        }, clock_type::now());
+    }
+
+    q.push([& finish] { finish = true; });
+    consumer.join();
+
+    std::sort(latencies.begin(), latencies.end());
+    return latencies;
+}
+
+double percentile (std::vector<double> const & sorted, double p)
+{
+    auto index = static_cast<std::size_t>(p * static_cast<double>(sorted.size() - 1));
+    return sorted[index];
+}
+
+int main ()
+{
+    using std::chrono::microseconds;
+
+    strategy strategies[] = {
+          {"park", microseconds{0}, microseconds{0}}
+        , {"spin", microseconds{200}, microseconds{0}}
+        , {"yield", microseconds{0}, microseconds{200}}
+        , {"spin+yield", microseconds{20}, microseconds{200}}
+    };
+
+    if (std::thread::hardware_concurrency() < 2)
+        std::printf("NOTE: single CPU, spinning consumer delays the producer\n");
+
+    std::printf("%-12s %10s %10s %10s %10s\n", "strategy", "p50, us", "p99, us", "p999, us", "max, us");
+
+    for (auto const & s: strategies) {
+        auto latencies = run(s);
+
+        std::printf("%-12s %10.2f %10.2f %10.2f %10.2f\n", s.name
+            , percentile(latencies, 0.5)
+            , percentile(latencies, 0.99)
+            , percentile(latencies, 0.999)
+            , latencies.back());
+    }
+
+    return 0;
+}
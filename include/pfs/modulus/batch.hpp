@@ -0,0 +1,78 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Vladislav Trifochkin
+//
+// License: see LICENSE file
+//
+// This file is part of `modulus2-lib`.
+//
+// Changelog:
+//      2026.10.17 Initial version.
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "namespace.hpp"
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+MODULUS__NAMESPACE_BEGIN
+
+/**
+ * Immutable batch of events. Batch is emitted as a single value, so all
+ * detectors (including queued ones) share the single instance of events.
+ */
+template <typename T>
+class batch
+{
+public:
+    using value_type = T;
+    using const_iterator = typename std::vector<T>::const_iterator;
+
+private:
+    std::shared_ptr<std::vector<T> const> _events;
+
+public:
+    batch () = default;
+
+    explicit batch (std::vector<T> && events)
+        : _events(std::make_shared<std::vector<T> const>(std::move(events)))
+    {}
+
+    template <typename InputIt>
+    batch (InputIt first, InputIt last)
+        : _events(std::make_shared<std::vector<T> const>(first, last))
+    {}
+
+    const_iterator begin () const noexcept
+    {
+        return _events ? _events->begin() : const_iterator{};
+    }
+
+    const_iterator end () const noexcept
+    {
+        return _events ? _events->end() : const_iterator{};
+    }
+
+    T const * data () const noexcept
+    {
+        return _events ? _events->data() : nullptr;
+    }
+
+    std::size_t size () const noexcept
+    {
+        return _events ? _events->size() : 0;
+    }
+
+    bool empty () const noexcept
+    {
+        return size() == 0;
+    }
+
+    T const & operator [] (std::size_t i) const
+    {
+        return (*_events)[i];
+    }
+};
+
+MODULUS__NAMESPACE_END
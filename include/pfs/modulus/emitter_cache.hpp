@@ -0,0 +1,189 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Vladislav Trifochkin
+//
+// License: see LICENSE file
+//
+// This file is part of `modulus2-lib`.
+//
+// Changelog:
+//      2026.10.17 Initial version.
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "namespace.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+MODULUS__NAMESPACE_BEGIN
+
+/**
+ * API identifier traits. API identifiers of integral and enumeration types
+ * are expected to be dense values (e.g. enumerators), so emitters are
+ * cached in direct-indexed table. Specialize for custom ApiIdType if needed.
+ */
+template <typename ApiIdType, typename = void>
+struct api_id_traits
+{
+    static constexpr bool dense = false;
+};
+
+template <typename ApiIdType>
+struct api_id_traits<ApiIdType, typename std::enable_if<std::is_integral<ApiIdType>::value
+    || std::is_enum<ApiIdType>::value>::type>
+{
+    static constexpr bool dense = true;
+
+    template <typename T = ApiIdType>
+    static typename std::enable_if<std::is_enum<T>::value, std::ptrdiff_t>::type
+    index (T id) noexcept
+    {
+        return static_cast<std::ptrdiff_t>(static_cast<typename std::underlying_type<T>::type>(id));
+    }
+
+    template <typename T = ApiIdType>
+    static typename std::enable_if<!std::is_enum<T>::value, std::ptrdiff_t>::type
+    index (T id) noexcept
+    {
+        return static_cast<std::ptrdiff_t>(id);
+    }
+};
+
+/**
+ * Flat map from API identifier to emitter pointer. Items are stored in
+ * the vector sorted by identifier, dense identifiers are additionally indexed
+ * by direct-indexed table covering range [min id, max id] while the range is
+ * not too sparse.
+ */
+template <typename ApiIdType, typename ValueType
+    , bool Dense = api_id_traits<ApiIdType>::dense>
+class emitter_cache
+{
+public:
+    using key_type = ApiIdType;
+    using value_type = std::pair<ApiIdType, ValueType *>;
+    using const_iterator = typename std::vector<value_type>::const_iterator;
+
+protected:
+    std::vector<value_type> _items;
+
+protected:
+    typename std::vector<value_type>::iterator lower_bound (key_type const & id)
+    {
+        return std::lower_bound(_items.begin(), _items.end(), id
+            , [] (value_type const & item, key_type const & id) { return item.first < id; });
+    }
+
+public:
+    /**
+     * Inserts @a value with @a id if there is no item with such identifier.
+     *
+     * @return @c true if item inserted.
+     */
+    bool emplace (key_type const & id, ValueType * value)
+    {
+        auto pos = lower_bound(id);
+
+        if (pos != _items.end() && !(id < pos->first))
+            return false;
+
+        _items.emplace(pos, id, value);
+        return true;
+    }
+
+    /**
+     * @return Pointer associated with @a id or @c nullptr.
+     */
+    ValueType * find (key_type const & id) const
+    {
+        auto pos = std::lower_bound(_items.begin(), _items.end(), id
+            , [] (value_type const & item, key_type const & id) { return item.first < id; });
+
+        if (pos != _items.end() && !(id < pos->first))
+            return pos->second;
+
+        return nullptr;
+    }
+
+    const_iterator begin () const noexcept
+    {
+        return _items.begin();
+    }
+
+    const_iterator end () const noexcept
+    {
+        return _items.end();
+    }
+
+    std::size_t size () const noexcept
+    {
+        return _items.size();
+    }
+
+    bool empty () const noexcept
+    {
+        return _items.empty();
+    }
+};
+
+template <typename ApiIdType, typename ValueType>
+class emitter_cache<ApiIdType, ValueType, true>
+    : public emitter_cache<ApiIdType, ValueType, false>
+{
+    using base_class = emitter_cache<ApiIdType, ValueType, false>;
+    using traits_type = api_id_traits<ApiIdType>;
+
+public:
+    using key_type = typename base_class::key_type;
+
+private:
+    std::ptrdiff_t _base {0};
+    std::vector<ValueType *> _table;
+
+private:
+    void rebuild_table ()
+    {
+        auto & items = this->_items;
+        auto first = traits_type::index(items.front().first);
+        auto last = traits_type::index(items.back().first);
+        // Unsigned arithmetic: wrapped span of extreme values is too sparse
+        auto span = static_cast<std::size_t>(last) - static_cast<std::size_t>(first) + 1;
+
+        _table.clear();
+
+        // Too sparse, use binary search
+        if (span > 4 * items.size() + 16)
+            return;
+
+        _base = first;
+        _table.resize(span, nullptr);
+
+        for (auto const & item: items)
+            _table[static_cast<std::size_t>(traits_type::index(item.first) - _base)] = item.second;
+    }
+
+public:
+    bool emplace (key_type const & id, ValueType * value)
+    {
+        if (!base_class::emplace(id, value))
+            return false;
+
+        rebuild_table();
+        return true;
+    }
+
+    ValueType * find (key_type const & id) const
+    {
+        if (_table.empty())
+            return base_class::find(id);
+
+        auto index = traits_type::index(id) - _base;
+
+        return index >= 0 && static_cast<std::size_t>(index) < _table.size()
+            ? _table[static_cast<std::size_t>(index)]
+            : nullptr;
+    }
+};
+
+MODULUS__NAMESPACE_END
@@ -0,0 +1,664 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Vladislav Trifochkin
+//
+// License: see LICENSE file
+//
+// This file is part of `modulus2-lib`.
+//
+// Changelog:
+//      2026.10.17 Initial version.
+//      2026.10.17 Thread pool starts fsync after previous operations
+//                 complete, io_uring opcodes are probed, read/write sizes
+//                 are clamped.
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "namespace.hpp"
+#include "worker_pool.hpp"
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#   include <unistd.h>
+#   include <cerrno>
+#   include <cstring>
+#   define MODULUS__IO_SERVICE_ENABLED 1
+#endif
+
+#if __linux__ && defined(__has_include)
+#   if __has_include(<linux/io_uring.h>)
+#       include <linux/io_uring.h>
+#       include <sys/mman.h>
+#       include <sys/syscall.h>
+        // IORING_FEAT_RW_CUR_POS appeared with IORING_REGISTER_PROBE (Linux 5.6)
+#       if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter) \
+            && defined(__NR_io_uring_register) && defined(IORING_FEAT_RW_CUR_POS)
+#           include <vector>
+#           define MODULUS__IO_URING_ENABLED 1
+#       endif
+#   endif
+#endif
+
+MODULUS__NAMESPACE_BEGIN
+
+/**
+ * Asynchronous file I/O implementation used by the dispatcher.
+ */
+enum class io_backend
+{
+      io_uring    // Linux io_uring (falls back to thread_pool if not available)
+    , thread_pool // Blocking calls on the pool of threads
+};
+
+/**
+ * Result of the asynchronous I/O operation.
+ */
+struct io_result
+{
+    std::size_t bytes {0}; // Number of bytes read or written
+    int error {0};         // errno value, zero on success
+
+    bool ok () const noexcept
+    {
+        return error == 0;
+    }
+};
+
+#if MODULUS__IO_SERVICE_ENABLED
+
+/**
+ * Asynchronous file I/O service interface. Completion callback is pushed into
+ * the queue specified at submission or called directly from the service
+ * thread if the queue is null. Buffer must be valid until the callback is
+ * called.
+ *
+ * Operations may complete in any order, except fsync that starts after all
+ * previously submitted operations complete.
+ */
+template <typename QueueType>
+class basic_io_service
+{
+public:
+    using callback_type = std::function<void(io_result)>;
+
+protected:
+    static void complete (QueueType * callback_queue, callback_type & callback, io_result result)
+    {
+        if (callback_queue) {
+            callback_queue->push(std::move(callback), result);
+        } else {
+            callback(result);
+        }
+    }
+
+public:
+    virtual ~basic_io_service () {}
+
+    virtual io_backend backend () const noexcept = 0;
+
+    /**
+     * Reads up to @a size bytes from @a fd at @a offset (at the current file
+     * position if negative) into @a buf.
+     *
+     * @return @c false if service is stopped or operation can't be submitted.
+     */
+    virtual bool read (int fd, void * buf, std::size_t size, std::int64_t offset
+        , QueueType * callback_queue, callback_type && callback) = 0;
+
+    /**
+     * Writes @a size bytes from @a buf to @a fd at @a offset (at the current
+     * file position if negative). As write(2) it may write less than
+     * @a size bytes.
+     *
+     * @return @c false if service is stopped or operation can't be submitted.
+     */
+    virtual bool write (int fd, void const * buf, std::size_t size, std::int64_t offset
+        , QueueType * callback_queue, callback_type && callback) = 0;
+
+    /**
+     * Flushes @a fd to the storage device (data only if @a data_only is
+     * @c true, see fdatasync(2)) after all previously submitted operations
+     * complete.
+     *
+     * @return @c false if service is stopped or operation can't be submitted.
+     */
+    virtual bool fsync (int fd, bool data_only
+        , QueueType * callback_queue, callback_type && callback) = 0;
+
+    /**
+     * Rejects new operations and waits for submitted ones. Callbacks of the
+     * completed operations are pushed into queues even if nobody processes
+     * them anymore.
+     */
+    virtual void stop () = 0;
+};
+
+/**
+ * Performs blocking pread/pwrite/fsync calls on the worker pool. Operations
+ * are executed in submission order if pool has single thread. Otherwise they
+ * run concurrently except fsync: it starts after all previously submitted
+ * operations complete and operations submitted after it wait for its
+ * completion (as IOSQE_IO_DRAIN of io_uring).
+ */
+template <typename QueueType>
+class thread_pool_io_service: public basic_io_service<QueueType>
+{
+    using base_class = basic_io_service<QueueType>;
+
+public:
+    using callback_type = typename base_class::callback_type;
+
+private:
+    struct held_operation
+    {
+        bool barrier;
+        worker_pool::task_type task;
+    };
+
+    worker_pool _pool;
+
+    std::mutex _mtx;
+    std::condition_variable _cond;
+
+    // Submitted and not completed operations (including held ones)
+    std::size_t _pending {0};
+
+    // Operations posted to the pool and not completed yet
+    std::size_t _running {0};
+
+    // Operations waiting for the barrier (fsync) to start or to complete
+    std::deque<held_operation> _held;
+    bool _barrier_running {false};
+
+    bool _stopped {false};
+
+private:
+    template <typename Operation>
+    static io_result perform (Operation && op)
+    {
+        ssize_t n = 0;
+
+        do {
+            n = op();
+        } while (n < 0 && errno == EINTR);
+
+        io_result result;
+
+        if (n < 0)
+            result.error = errno;
+        else
+            result.bytes = static_cast<std::size_t>(n);
+
+        return result;
+    }
+
+    // Must be called with locked _mtx. Posts held operations up to the
+    // barrier, the barrier is posted when nothing else is running.
+    void dispatch_locked ()
+    {
+        while (!_held.empty() && !_barrier_running) {
+            auto & front = _held.front();
+
+            if (front.barrier) {
+                if (_running > 0)
+                    break;
+
+                _barrier_running = true;
+            }
+
+            ++_running;
+            _pool.post(std::move(front.task));
+            _held.pop_front();
+        }
+    }
+
+    template <typename Operation>
+    bool submit (Operation && op, QueueType * callback_queue, callback_type && callback
+        , bool barrier = false)
+    {
+        std::unique_lock<std::mutex> locker(_mtx);
+
+        if (_stopped)
+            return false;
+
+        ++_pending;
+
+        _held.push_back(held_operation{barrier, [this, op, callback_queue, barrier
+                , cb = std::move(callback)] () mutable {
+            this->complete(callback_queue, cb, perform(op));
+
+            std::unique_lock<std::mutex> locker(_mtx);
+
+            --_running;
+
+            if (barrier)
+                _barrier_running = false;
+
+            dispatch_locked();
+
+            if (--_pending == 0)
+                _cond.notify_all();
+        }});
+
+        dispatch_locked();
+
+        return true;
+    }
+
+public:
+    explicit thread_pool_io_service (std::size_t thread_count = 1)
+        : _pool(thread_count == 0 ? 1 : thread_count)
+    {}
+
+    ~thread_pool_io_service ()
+    {
+        stop();
+    }
+
+    io_backend backend () const noexcept override
+    {
+        return io_backend::thread_pool;
+    }
+
+    bool read (int fd, void * buf, std::size_t size, std::int64_t offset
+        , QueueType * callback_queue, callback_type && callback) override
+    {
+        return submit([fd, buf, size, offset] {
+            return offset < 0
+                ? ::read(fd, buf, size)
+                : ::pread(fd, buf, size, static_cast<off_t>(offset));
+        }, callback_queue, std::move(callback));
+    }
+
+    bool write (int fd, void const * buf, std::size_t size, std::int64_t offset
+        , QueueType * callback_queue, callback_type && callback) override
+    {
+        return submit([fd, buf, size, offset] {
+            return offset < 0
+                ? ::write(fd, buf, size)
+                : ::pwrite(fd, buf, size, static_cast<off_t>(offset));
+        }, callback_queue, std::move(callback));
+    }
+
+    bool fsync (int fd, bool data_only
+        , QueueType * callback_queue, callback_type && callback) override
+    {
+        return submit([fd, data_only] () -> ssize_t {
+#if __linux__
+            return data_only ? ::fdatasync(fd) : ::fsync(fd);
+#else
+            (void)data_only;
+            return ::fsync(fd);
+#endif
+        }, callback_queue, std::move(callback), true);
+    }
+
+    void stop () override
+    {
+        std::unique_lock<std::mutex> locker(_mtx);
+        _stopped = true;
+        _cond.wait(locker, [this] { return _pending == 0; });
+        locker.unlock();
+
+        _pool.stop();
+    }
+};
+
+#endif // MODULUS__IO_SERVICE_ENABLED
+
+#if MODULUS__IO_URING_ENABLED
+
+/**
+ * Submits operations to the io_uring instance (raw system calls, liburing is
+ * not required). Completions are reaped by the dedicated thread.
+ */
+template <typename QueueType>
+class io_uring_service: public basic_io_service<QueueType>
+{
+    using base_class = basic_io_service<QueueType>;
+
+public:
+    using callback_type = typename base_class::callback_type;
+
+private:
+    struct operation
+    {
+        QueueType * callback_queue;
+        callback_type callback;
+    };
+
+    struct mapping
+    {
+        void * ptr {MAP_FAILED};
+        std::size_t size {0};
+
+        ~mapping ()
+        {
+            if (ptr != MAP_FAILED)
+                ::munmap(ptr, size);
+        }
+    };
+
+    int _ring_fd {-1};
+    mapping _sq_ring;
+    mapping _cq_ring;
+    mapping _sqes_map;
+
+    // Submission ring (guarded by _mtx)
+    unsigned * _sq_tail {nullptr};
+    unsigned * _sq_array {nullptr};
+    unsigned _sq_mask {0};
+    io_uring_sqe * _sqes {nullptr};
+
+    // Completion ring (accessed by completion thread only)
+    unsigned * _cq_head {nullptr};
+    unsigned * _cq_tail {nullptr};
+    unsigned _cq_mask {0};
+    io_uring_cqe * _cqes {nullptr};
+
+    std::mutex _mtx;
+    std::condition_variable _cond;
+
+    // Operations submitted but not reaped yet. Limited by the completion
+    // ring capacity (one entry is reserved for stop marker).
+    std::size_t _in_flight {0};
+    std::size_t _max_in_flight {0};
+    bool _stopped {false};
+
+    std::thread _completion_thread;
+
+    // Maximum number of bytes transferred by single read/write (MAX_RW_COUNT
+    // of Linux), larger sizes are clamped (partial transfer as by read(2)
+    // and write(2))
+    static constexpr std::size_t max_rw_size = 0x7ffff000;
+
+private:
+    static std::string error_string (char const * func)
+    {
+        return std::string{func} + " failure: " + std::strerror(errno);
+    }
+
+    static std::uint32_t clamp_size (std::size_t size) noexcept
+    {
+        return static_cast<std::uint32_t>(size < max_rw_size ? size : max_rw_size);
+    }
+
+    // Checks opcodes used by the service are supported: IORING_OP_READ and
+    // IORING_OP_WRITE, reading/writing at the current file position require
+    // Linux 5.6
+    std::string probe (io_uring_params const & params)
+    {
+        if ((params.features & IORING_FEAT_RW_CUR_POS) == 0)
+            return "io_uring: current file position is not supported";
+
+        constexpr unsigned op_count = 256;
+        std::vector<char> buf(sizeof(io_uring_probe) + op_count * sizeof(io_uring_probe_op), 0);
+        auto p = reinterpret_cast<io_uring_probe *>(buf.data());
+
+        if (::syscall(__NR_io_uring_register, _ring_fd, IORING_REGISTER_PROBE, p, op_count) < 0)
+            return error_string("io_uring_register");
+
+        for (unsigned opcode: {IORING_OP_NOP, IORING_OP_READ, IORING_OP_WRITE, IORING_OP_FSYNC}) {
+            if (opcode > p->last_op || (p->ops[opcode].flags & IO_URING_OP_SUPPORTED) == 0)
+                return "io_uring: opcode " + std::to_string(opcode) + " is not supported";
+        }
+
+        return std::string{};
+    }
+
+    int enter (unsigned to_submit, unsigned min_complete, unsigned flags)
+    {
+        return static_cast<int>(::syscall(__NR_io_uring_enter, _ring_fd
+            , to_submit, min_complete, flags, nullptr, 0));
+    }
+
+    static bool map (mapping & m, int fd, std::size_t size, off_t offset)
+    {
+        m.size = size;
+        m.ptr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE
+            , fd, offset);
+
+        return m.ptr != MAP_FAILED;
+    }
+
+    template <typename T>
+    static T * at (mapping const & m, std::uint32_t offset)
+    {
+        return reinterpret_cast<T *>(static_cast<char *>(m.ptr) + offset);
+    }
+
+    // Must be called with locked _mtx. If @a user_data is zero, submits stop
+    // marker.
+    bool submit_locked (std::uint8_t opcode, std::uint8_t flags, int fd
+        , std::uint64_t addr, std::uint32_t len, std::uint64_t offset
+        , std::uint32_t op_flags, std::uint64_t user_data)
+    {
+        auto tail = *_sq_tail;
+        auto index = tail & _sq_mask;
+        auto sqe = & _sqes[index];
+
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = opcode;
+        sqe->flags = flags;
+        sqe->fd = fd;
+        sqe->addr = addr;
+        sqe->len = len;
+        sqe->off = offset;
+        sqe->fsync_flags = op_flags;
+        sqe->user_data = user_data;
+
+        _sq_array[index] = index;
+        __atomic_store_n(_sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+        int rc = 0;
+
+        do {
+            rc = enter(1, 0, 0);
+        } while (rc < 0 && errno == EINTR);
+
+        // Kernel did not consume the entry, nobody else submits while
+        // _mtx is locked, so it is safe to take it back
+        if (rc < 1) {
+            __atomic_store_n(_sq_tail, tail, __ATOMIC_RELEASE);
+            return false;
+        }
+
+        return true;
+    }
+
+    bool submit (std::uint8_t opcode, std::uint8_t flags, int fd
+        , std::uint64_t addr, std::uint32_t len, std::int64_t offset
+        , std::uint32_t op_flags, QueueType * callback_queue, callback_type && callback)
+    {
+        std::unique_lock<std::mutex> locker(_mtx);
+        _cond.wait(locker, [this] { return _stopped || _in_flight < _max_in_flight; });
+
+        if (_stopped)
+            return false;
+
+        auto op = new operation{callback_queue, std::move(callback)};
+
+        // Offset -1 means current file position
+        auto off = offset < 0 ? static_cast<std::uint64_t>(-1) : static_cast<std::uint64_t>(offset);
+
+        if (!submit_locked(opcode, flags, fd, addr, len, off, op_flags
+                , reinterpret_cast<std::uintptr_t>(op))) {
+            delete op;
+            return false;
+        }
+
+        ++_in_flight;
+        return true;
+    }
+
+    void completion_main ()
+    {
+        for (;;) {
+            auto rc = enter(0, 1, IORING_ENTER_GETEVENTS);
+
+            if (rc < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY)
+                break;
+
+            // Operations are passed through the kernel, so synchronize with
+            // submitters (they hold the mutex until submission returns)
+            std::unique_lock<std::mutex> locker(_mtx);
+            auto head = *_cq_head;
+            auto tail = __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE);
+            locker.unlock();
+
+            std::size_t completed = 0;
+
+            for (; head != tail; ++head) {
+                auto const & cqe = _cqes[head & _cq_mask];
+
+                // Stop marker
+                if (cqe.user_data == 0)
+                    continue;
+
+                auto op = reinterpret_cast<operation *>(static_cast<std::uintptr_t>(cqe.user_data));
+                io_result result;
+
+                if (cqe.res < 0)
+                    result.error = -cqe.res;
+                else
+                    result.bytes = static_cast<std::size_t>(cqe.res);
+
+                this->complete(op->callback_queue, op->callback, result);
+                delete op;
+                ++completed;
+            }
+
+            __atomic_store_n(_cq_head, head, __ATOMIC_RELEASE);
+
+            locker.lock();
+            _in_flight -= completed;
+            _cond.notify_all();
+
+            if (_stopped && _in_flight == 0)
+                break;
+        }
+    }
+
+public:
+    io_uring_service () = default;
+
+    io_uring_service (io_uring_service const &) = delete;
+    io_uring_service & operator = (io_uring_service const &) = delete;
+    io_uring_service (io_uring_service &&) = delete;
+    io_uring_service & operator = (io_uring_service &&) = delete;
+
+    ~io_uring_service ()
+    {
+        stop();
+
+        if (_ring_fd >= 0)
+            ::close(_ring_fd);
+    }
+
+    /**
+     * Creates io_uring instance with @a entries submission queue entries and
+     * starts completion thread.
+     *
+     * @return Error description or empty string on success (e.g. io_uring is
+     *         not supported by the kernel, it lacks required opcodes or it is
+     *         disabled by seccomp policy).
+     */
+    std::string open (unsigned entries = 256)
+    {
+        io_uring_params params;
+        std::memset(& params, 0, sizeof(params));
+
+        _ring_fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, & params));
+
+        if (_ring_fd < 0)
+            return error_string("io_uring_setup");
+
+        auto error = probe(params);
+
+        if (!error.empty())
+            return error;
+
+        if (!map(_sq_ring, _ring_fd, params.sq_off.array + params.sq_entries * sizeof(unsigned)
+                , IORING_OFF_SQ_RING)) {
+            return error_string("mmap");
+        }
+
+        if (!map(_cq_ring, _ring_fd, params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe)
+                , IORING_OFF_CQ_RING)) {
+            return error_string("mmap");
+        }
+
+        if (!map(_sqes_map, _ring_fd, params.sq_entries * sizeof(io_uring_sqe), IORING_OFF_SQES))
+            return error_string("mmap");
+
+        _sq_tail  = at<unsigned>(_sq_ring, params.sq_off.tail);
+        _sq_array = at<unsigned>(_sq_ring, params.sq_off.array);
+        _sq_mask  = *at<unsigned>(_sq_ring, params.sq_off.ring_mask);
+        _sqes     = static_cast<io_uring_sqe *>(_sqes_map.ptr);
+
+        _cq_head  = at<unsigned>(_cq_ring, params.cq_off.head);
+        _cq_tail  = at<unsigned>(_cq_ring, params.cq_off.tail);
+        _cq_mask  = *at<unsigned>(_cq_ring, params.cq_off.ring_mask);
+        _cqes     = at<io_uring_cqe>(_cq_ring, params.cq_off.cqes);
+
+        _max_in_flight = params.cq_entries - 1;
+        _completion_thread = std::thread{& io_uring_service::completion_main, this};
+
+        return std::string{};
+    }
+
+    io_backend backend () const noexcept override
+    {
+        return io_backend::io_uring;
+    }
+
+    bool read (int fd, void * buf, std::size_t size, std::int64_t offset
+        , QueueType * callback_queue, callback_type && callback) override
+    {
+        return submit(IORING_OP_READ, 0, fd, reinterpret_cast<std::uintptr_t>(buf)
+            , clamp_size(size), offset, 0, callback_queue, std::move(callback));
+    }
+
+    bool write (int fd, void const * buf, std::size_t size, std::int64_t offset
+        , QueueType * callback_queue, callback_type && callback) override
+    {
+        return submit(IORING_OP_WRITE, 0, fd, reinterpret_cast<std::uintptr_t>(buf)
+            , clamp_size(size), offset, 0, callback_queue, std::move(callback));
+    }
+
+    bool fsync (int fd, bool data_only
+        , QueueType * callback_queue, callback_type && callback) override
+    {
+        return submit(IORING_OP_FSYNC, IOSQE_IO_DRAIN, fd, 0, 0, 0
+            , data_only ? IORING_FSYNC_DATASYNC : 0u
+            , callback_queue, std::move(callback));
+    }
+
+    void stop () override
+    {
+        std::unique_lock<std::mutex> locker(_mtx);
+
+        if (!_completion_thread.joinable())
+            return;
+
+        _stopped = true;
+        _cond.notify_all();
+
+        // Completion thread may wait for completions while nothing is in
+        // flight, so wake it up by no-op
+        submit_locked(IORING_OP_NOP, 0, -1, 0, 0, 0, 0, 0);
+
+        locker.unlock();
+        _completion_thread.join();
+    }
+};
+
+#endif // MODULUS__IO_URING_ENABLED
+
+MODULUS__NAMESPACE_END
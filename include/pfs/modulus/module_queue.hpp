@@ -0,0 +1,1206 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Vladislav Trifochkin
+//
+// License: see LICENSE file
+//
+// This file is part of `modulus2-lib`.
+//
+// Changelog:
+//      2026.10.17 Initial version.
+//      2026.10.17 Added notifier.
+//      2026.10.17 Added owner thread tracking.
+//      2026.10.17 Added action deadlines.
+//      2026.10.17 Added priority lanes.
+//      2026.10.17 Added fair subqueues.
+//      2026.10.17 Added time-budgeted draining.
+//      2026.10.17 Added spin-then-park wait strategy.
+//      2026.10.17 Notifier can be replaced while producers are pushing.
+//      2026.10.17 Policy overflow_policy::drop_oldest evicts the oldest action
+//                 at push time.
+//      2026.10.17 Added push with discard callback.
+//      2026.10.17 Starvation protection credits each lower priority lane.
+//      2026.10.17 Inline call checks pending actions of the root queue.
+//      2026.10.17 Added push not limited by capacity for internal actions.
+//      2026.10.17 Deadline scope is applied by emitter connections only.
+//      2026.10.17 At most one wakeup action is pending.
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "namespace.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#   include <immintrin.h>
+#endif
+
+MODULUS__NAMESPACE_BEGIN
+
+/**
+ * Hints the CPU that the thread is in spin-wait loop (reduces power
+ * consumption and the penalty of leaving the loop).
+ */
+inline void cpu_relax () noexcept
+{
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+/**
+ * Behavior of the bounded queue when it is full.
+ */
+enum class overflow_policy
+{
+      block       // Block the producer until there is a free space
+    , drop_newest // Silently drop the action being pushed
+    , drop_oldest // Drop the oldest pending action of the lowest priority
+                  // lane not higher than the pushed action's one (drop the
+                  // action being pushed if there is no such action)
+    , fail        // Reject the action being pushed, push() returns false
+};
+
+/**
+ * Priority lane of the module queue. Actions of higher priority lane are
+ * called first.
+ */
+enum class queue_priority
+{
+      high   // Control traffic (e.g. configuration changes)
+    , normal // Default lane
+    , low    // Bulk traffic
+};
+
+struct queue_options
+{
+    // Maximum number of pending actions, zero means unlimited.
+    std::size_t capacity {0};
+    overflow_policy overflow {overflow_policy::block};
+
+    // Maximum number of actions called from higher priority lanes in a row
+    // while lower priority lane has pending actions (starvation protection).
+    std::size_t starvation_limit {16};
+
+    // Share of the parent queue processing for subqueue (e.g. queue of the
+    // guest module): number of actions called per deficit round-robin turn.
+    std::size_t weight {1};
+
+    // Wait strategy of the consumer: busy-spin for spin_time, then yield
+    // the CPU for yield_time, then park until an action is pushed. Zero
+    // times mean parking immediately (lowest CPU usage, highest wakeup
+    // latency).
+    std::chrono::microseconds spin_time {0};
+    std::chrono::microseconds yield_time {0};
+};
+
+using deadline_clock = std::chrono::steady_clock;
+
+/**
+ * Deadline of the emissions to queued detectors made by the current thread
+ * while the scope exists (see modulus::ttl_emitter). Applied by emitter
+ * connections only (see module_queue::push_discardable_until()): actions
+ * pushed into the queues directly (log records, timer callbacks, replies of
+ * remote procedure calls) and by detectors called inline are not limited.
+ * Nested scope can shorten the deadline only.
+ */
+class deadline_scope
+{
+public:
+    // Tag of the scope lifting the deadline (e.g. while the detector is
+    // called inline from the emission)
+    struct none {};
+
+private:
+    deadline_clock::time_point _prev;
+
+private:
+    static deadline_clock::time_point & current ()
+    {
+        static thread_local deadline_clock::time_point deadline = deadline_clock::time_point::max();
+        return deadline;
+    }
+
+public:
+    explicit deadline_scope (deadline_clock::time_point deadline)
+        : _prev(current())
+    {
+        if (deadline < _prev)
+            current() = deadline;
+    }
+
+    explicit deadline_scope (none)
+        : _prev(current())
+    {
+        current() = deadline_clock::time_point::max();
+    }
+
+    /**
+     * Sets deadline to now plus @a ttl (time to live).
+     */
+    template <typename Rep, typename Period>
+    explicit deadline_scope (std::chrono::duration<Rep, Period> ttl)
+        : deadline_scope(deadline_clock::now()
+            + std::chrono::duration_cast<deadline_clock::duration>(ttl))
+    {}
+
+    deadline_scope (deadline_scope const &) = delete;
+    deadline_scope & operator = (deadline_scope const &) = delete;
+
+    ~deadline_scope ()
+    {
+        current() = _prev;
+    }
+
+    /**
+     * Current thread's deadline, deadline_clock::time_point::max() if there
+     * is no deadline.
+     */
+    static deadline_clock::time_point current_deadline () noexcept
+    {
+        return current();
+    }
+};
+
+/**
+ * Priority lane of the actions pushed into module queues by the current
+ * thread while the scope exists.
+ */
+class priority_scope
+{
+    queue_priority _prev;
+
+private:
+    static queue_priority & current ()
+    {
+        static thread_local queue_priority priority = queue_priority::normal;
+        return priority;
+    }
+
+public:
+    explicit priority_scope (queue_priority priority)
+        : _prev(current())
+    {
+        current() = priority;
+    }
+
+    priority_scope (priority_scope const &) = delete;
+    priority_scope & operator = (priority_scope const &) = delete;
+
+    ~priority_scope ()
+    {
+        current() = _prev;
+    }
+
+    static queue_priority current_priority () noexcept
+    {
+        return current();
+    }
+};
+
+/**
+ * Queue of the dispatcher and runnable modules. Wraps FunctionQueueType
+ * (see requirements in modulus.hpp) and adds priority lanes, capacity limit
+ * with overflow policies and statistics.
+ *
+ * Each priority lane is the separate FunctionQueueType instance, the consumer
+ * waits on the normal lane (actions pushed into other lanes wake it up if
+ * needed).
+ *
+ * Queue can be attached to the parent queue as subqueue (see
+ * attach_subqueue()). The parent's consumer calls actions of own lanes and
+ * subqueues in deficit round-robin manner according to subqueue weights, so
+ * busy subqueue does not starve others.
+ *
+ * Actions of the queue with @c overflow_policy::drop_oldest policy are kept
+ * in per lane deques (rings) instead of lanes, so the oldest action can be
+ * evicted (and destroyed) at push time. Lane contains a trampoline per ring
+ * action instead, which calls the first action of the ring. The trampoline of
+ * the action evicted from another lane remains in its lane, it is counted as
+ * debt and reused by the next action pushed into that lane, so the number of
+ * trampolines never exceeds capacity.
+ *
+ * NOTE! Producer blocked by @c overflow_policy::block policy is released by
+ * the consumer only, so the consumer must not push into own full queue with
+ * this policy (internal actions that may be pushed by the consumer are pushed
+ * by push_unbounded()).
+ */
+template <typename FunctionQueueType>
+class module_queue
+{
+public:
+    using queue_type = FunctionQueueType;
+
+    // Called instead of the action dropped by overflow policy or discarded
+    // because of expired deadline
+    using discard_type = std::function<void()>;
+
+private:
+    static constexpr std::size_t lane_count = 3;
+    static constexpr std::size_t high_lane = static_cast<std::size_t>(queue_priority::high);
+    static constexpr std::size_t normal_lane = static_cast<std::size_t>(queue_priority::normal);
+    static constexpr std::size_t low_lane = static_cast<std::size_t>(queue_priority::low);
+
+    // Maximum number of actions called from the normal lane at once while
+    // other lanes are empty
+    static constexpr int normal_batch_size = 64;
+
+    queue_type _lanes[lane_count];
+
+    // Number of pushed and not yet called actions by lane (excluding wakeup
+    // actions)
+    std::atomic<std::size_t> _lane_counts[lane_count];
+
+    // Actions called from higher priority lanes in a row by lane while the
+    // lane has pending actions (used by consumer only)
+    std::size_t _skipped[lane_count] {0, 0, 0};
+
+    // Number of called actions excluding wakeup actions (used by consumer
+    // only)
+    std::size_t _called {0};
+
+    std::atomic<std::size_t> _capacity {0};
+    std::atomic<std::size_t> _starvation_limit {16};
+    std::atomic<overflow_policy> _overflow {overflow_policy::block};
+
+    // Number of pending actions (excluding dropped).
+    std::atomic<std::size_t> _count {0};
+    std::atomic<std::size_t> _high_water_mark {0};
+
+    // Actions of the queue with overflow_policy::drop_oldest policy (see
+    // class description)
+    struct ring_entry
+    {
+        std::function<void()> fn;
+        discard_type discard;
+    };
+
+    std::mutex _ring_mtx;
+    std::deque<ring_entry> _rings[lane_count];
+
+    // Number of trampolines without ring action by lane
+    std::size_t _ring_debts[lane_count] {0, 0, 0};
+
+    std::atomic<std::size_t> _dropped_count {0};
+    std::atomic<std::size_t> _rejected_count {0};
+    std::atomic<std::size_t> _expired_count {0};
+
+    // Called after each push (e.g. to schedule the queue processing on the
+    // worker pool or to wake up the reactor). Replaced notifiers are kept
+    // alive, so producers can call them while notifier is being replaced.
+    std::atomic<std::function<void()> *> _notifier {nullptr};
+    std::vector<std::unique_ptr<std::function<void()>>> _notifiers;
+    std::mutex _notifiers_mtx;
+
+    // Producers blocked by overflow_policy::block
+    std::atomic<int> _blocked_count {0};
+    std::mutex _space_mtx;
+    std::condition_variable _space_cond;
+
+    // Thread running the consumer loop (dedicated thread of the runnable
+    // module or the dispatcher)
+    std::atomic<std::thread::id> _owner {std::thread::id{}};
+
+    // Wait strategy (see queue_options::spin_time)
+    std::atomic<std::chrono::microseconds::rep> _spin_time {0};
+    std::atomic<std::chrono::microseconds::rep> _yield_time {0};
+
+    // Set by wakeup() for the consumer spinning or yielding (wakeup actions
+    // are not counted as pending)
+    std::atomic<bool> _signaled {false};
+
+    // Wakeup action is pushed into the normal lane and not called yet
+    std::atomic<bool> _wakeup_pending {false};
+
+    // Queue this one is attached to as subqueue
+    std::atomic<module_queue *> _parent {nullptr};
+    std::atomic<std::size_t> _weight {1};
+
+    // Remaining quota of the current round-robin turn (used by parent's
+    // consumer only)
+    std::size_t _deficit {0};
+
+    // Attached subqueues (copy-on-write list). The mutex is held by consumer
+    // while calling subqueue actions, so subqueue can't be detached (and
+    // destroyed) meanwhile.
+    using subqueue_list = std::vector<module_queue *>;
+    mutable std::recursive_mutex _subqueues_mtx;
+    std::shared_ptr<subqueue_list const> _subqueues;
+    std::atomic<bool> _has_subqueues {false};
+
+    // Round-robin turn: zero for own lanes, index + 1 for subqueue (used by
+    // consumer only)
+    std::size_t _turn {0};
+
+private:
+    // Queue the current thread is calling actions of
+    static module_queue const * & current_consumed ()
+    {
+        static thread_local module_queue const * q = nullptr;
+        return q;
+    }
+
+    class consumer_scope
+    {
+        module_queue const * _prev;
+
+    public:
+        consumer_scope (module_queue const * q)
+            : _prev(current_consumed())
+        {
+            current_consumed() = q;
+        }
+
+        ~consumer_scope ()
+        {
+            current_consumed() = _prev;
+        }
+    };
+
+    // Spins, then yields until there are actions to call or @a limit is
+    // reached. Returns false if the consumer must park.
+    bool wait_active (deadline_clock::time_point limit)
+    {
+        auto spin_time = std::chrono::microseconds{_spin_time.load(std::memory_order_relaxed)};
+        auto yield_time = std::chrono::microseconds{_yield_time.load(std::memory_order_relaxed)};
+
+        if (spin_time.count() == 0 && yield_time.count() == 0)
+            return !empty();
+
+        // Wakeup action of the cleared signal is still in the normal lane
+        _signaled.store(false);
+
+        auto now = deadline_clock::now();
+        auto spin_end = (std::min)(limit, now + spin_time);
+        auto yield_end = (std::min)(limit, spin_end + yield_time);
+
+        for (;;) {
+            if (_signaled.load() || !empty())
+                return true;
+
+            now = deadline_clock::now();
+
+            if (now < spin_end)
+                cpu_relax();
+            else if (now < yield_end)
+                std::this_thread::yield();
+            else
+                return false;
+        }
+    }
+
+    void notify ()
+    {
+        auto notifier = _notifier.load(std::memory_order_acquire);
+
+        if (notifier != nullptr)
+            (*notifier)();
+    }
+
+    // Subqueue actions are called by the parent's consumer
+    bool is_parent_consumer_thread () const noexcept
+    {
+        auto parent = _parent.load();
+        return parent != nullptr && parent->is_consumer_thread();
+    }
+
+    bool try_reserve (std::size_t * prev = nullptr)
+    {
+        auto n = _count.load();
+        auto capacity = _capacity.load();
+
+        while (capacity == 0 || n < capacity) {
+            if (_count.compare_exchange_weak(n, n + 1)) {
+                update_high_water_mark(n + 1);
+
+                if (prev != nullptr)
+                    *prev = n;
+
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void update_high_water_mark (std::size_t n)
+    {
+        auto hwm = _high_water_mark.load(std::memory_order_relaxed);
+
+        while (n > hwm && !_high_water_mark.compare_exchange_weak(hwm, n, std::memory_order_relaxed))
+            ;
+    }
+
+    void reserve_blocking (std::size_t * prev)
+    {
+        std::unique_lock<std::mutex> locker(_space_mtx);
+        ++_blocked_count;
+        _space_cond.wait(locker, [this, prev] { return try_reserve(prev); });
+        --_blocked_count;
+    }
+
+    void release_space ()
+    {
+        if (_blocked_count.load() > 0) {
+            std::unique_lock<std::mutex> locker(_space_mtx);
+            _space_cond.notify_all();
+        }
+    }
+
+    // Called by consumer before action invocation
+    void accept ()
+    {
+        --_count;
+        release_space();
+    }
+
+    template <typename F>
+    void push_reserved (std::size_t lane, F && f, bool first = false)
+    {
+        ++_lane_counts[lane];
+
+        _lanes[lane].push([this, lane, fn = std::forward<F>(f)] () mutable {
+            --_lane_counts[lane];
+            ++_called;
+            accept();
+            fn();
+        });
+
+        notify_pushed(lane, first);
+    }
+
+    // Pushes trampoline calling the first action of the ring
+    void push_trampoline (std::size_t lane, bool first)
+    {
+        ++_lane_counts[lane];
+
+        _lanes[lane].push([this, lane] {
+            --_lane_counts[lane];
+            ++_called;
+
+            ring_entry entry;
+
+            {
+                std::lock_guard<std::mutex> locker(_ring_mtx);
+                auto & ring = _rings[lane];
+
+                // Action of this trampoline was evicted
+                if (ring.empty()) {
+                    --_ring_debts[lane];
+                    return;
+                }
+
+                entry = std::move(ring.front());
+                ring.pop_front();
+            }
+
+            accept();
+            entry.fn();
+        });
+
+        notify_pushed(lane, first);
+    }
+
+    // Must be called with locked _ring_mtx.
+    // Returns false if trampoline needn't be pushed (debt is used).
+    bool ring_push_locked (std::size_t lane, ring_entry && entry)
+    {
+        _rings[lane].push_back(std::move(entry));
+
+        if (_ring_debts[lane] > 0) {
+            --_ring_debts[lane];
+            return false;
+        }
+
+        return true;
+    }
+
+    template <typename F>
+    void push_ring (std::size_t lane, F && f, discard_type && discard, bool first)
+    {
+        bool need_trampoline = false;
+
+        {
+            std::lock_guard<std::mutex> locker(_ring_mtx);
+            need_trampoline = ring_push_locked(lane
+                , ring_entry{std::forward<F>(f), std::move(discard)});
+        }
+
+        if (need_trampoline)
+            push_trampoline(lane, first);
+    }
+
+    // Replaces the oldest action of the lowest priority lane not higher than
+    // @a lane with the new one. Pending actions count is unchanged.
+    // Returns false if there is no action to evict.
+    template <typename F>
+    bool push_evicting (std::size_t lane, F && f, discard_type & discard)
+    {
+        ring_entry evicted;
+        bool need_trampoline = false;
+
+        {
+            std::lock_guard<std::mutex> locker(_ring_mtx);
+            auto victim = lane_count;
+
+            for (auto i = lane_count; i > lane; i--) {
+                if (!_rings[i - 1].empty()) {
+                    victim = i - 1;
+                    break;
+                }
+            }
+
+            if (victim == lane_count)
+                return false;
+
+            evicted = std::move(_rings[victim].front());
+            _rings[victim].pop_front();
+            ++_ring_debts[victim];
+
+            need_trampoline = ring_push_locked(lane
+                , ring_entry{std::forward<F>(f), std::move(discard)});
+        }
+
+        if (need_trampoline)
+            push_trampoline(lane, false);
+
+        if (evicted.discard)
+            evicted.discard();
+
+        return true;
+    }
+
+    // Pushes wakeup action into the normal lane (the consumer waits on) if
+    // there is no pending one, so wakeup actions never pile up while the
+    // consumer is busy with other lanes. Pending wakeup action is called
+    // after this call, so the consumer sees the action pushed before.
+    void push_wakeup ()
+    {
+        if (!_wakeup_pending.exchange(true))
+            _lanes[normal_lane].push([this] { _wakeup_pending.store(false); });
+    }
+
+    void notify_pushed (std::size_t lane, bool first)
+    {
+        // Consumer waits on the normal lane. If the normal lane has pending
+        // actions, the consumer will check other lanes after calling them.
+        if (lane != normal_lane && _lane_counts[normal_lane].load() == 0)
+            push_wakeup();
+
+        // Parent's consumer does not wait for non-empty subqueue (see wait())
+        if (first) {
+            auto parent = _parent.load();
+
+            if (parent != nullptr)
+                parent->wakeup();
+        }
+
+        notify();
+    }
+
+    template <typename F>
+    bool push_expiring (queue_priority priority, deadline_clock::time_point deadline, F && f
+        , discard_type && discard = nullptr)
+    {
+        if (deadline_clock::now() > deadline) {
+            ++_expired_count;
+
+            if (discard)
+                discard();
+
+            return true;
+        }
+
+        auto on_expired = discard;
+
+        return push_action(priority, [this, deadline, fn = std::forward<F>(f), on_expired] () mutable {
+            if (deadline_clock::now() > deadline) {
+                ++_expired_count;
+
+                if (on_expired)
+                    on_expired();
+            } else {
+                fn();
+            }
+        }, std::move(discard));
+    }
+
+    // Selects lane of the next action to call, returns lane_count if all
+    // lanes are empty
+    std::size_t select_lane ()
+    {
+        std::size_t first = 0;
+
+        while (first < lane_count && _lane_counts[first].load() == 0)
+            _skipped[first++] = 0;
+
+        if (first == lane_count)
+            return lane_count;
+
+        auto limit = _starvation_limit.load();
+
+        // The lowest priority starving lane is called first, so each lane
+        // gets its turn even if all higher priority lanes are saturated
+        for (auto lane = lane_count - 1; lane > first; lane--) {
+            if (_lane_counts[lane].load() == 0) {
+                _skipped[lane] = 0;
+            } else if (_skipped[lane] >= limit) {
+                _skipped[lane] = 0;
+                return lane;
+            }
+        }
+
+        _skipped[first] = 0;
+
+        for (auto lane = first + 1; lane < lane_count; lane++) {
+            if (_lane_counts[lane].load() > 0)
+                ++_skipped[lane];
+        }
+
+        return first;
+    }
+
+    // Calls actions of own lanes
+    std::size_t call_own (std::size_t max_count)
+    {
+        consumer_scope scope {this};
+        auto start = _called;
+
+        while (_called - start < max_count) {
+            auto lane = select_lane();
+            std::size_t k = 0;
+
+            if (lane == normal_lane && _lane_counts[high_lane].load() == 0
+                    && _lane_counts[low_lane].load() == 0) {
+                // Other lanes are empty, call normal lane actions in batch
+                auto batch_size = (std::min)(max_count - (_called - start)
+                    , static_cast<std::size_t>(normal_batch_size));
+                k = _lanes[normal_lane].call(static_cast<int>(batch_size));
+            } else if (lane != lane_count) {
+                auto called = _called;
+
+                // Wakeup actions of the normal lane do not consume its turn
+                do {
+                    k = _lanes[lane].call();
+                } while (k > 0 && _called == called);
+            }
+
+            // Wakeup actions or action being pushed now
+            if (k == 0)
+                k = _lanes[normal_lane].call();
+
+            if (k == 0)
+                break;
+        }
+
+        return _called - start;
+    }
+
+    std::size_t call_lanes (std::size_t max_count)
+    {
+        if (!_has_subqueues.load())
+            return call_own(max_count);
+
+        std::lock_guard<std::recursive_mutex> locker(_subqueues_mtx);
+        auto subqueues = _subqueues;
+        auto participant_count = subqueues->size() + 1;
+        std::size_t n = 0;
+
+        // Number of participants in a row found empty
+        std::size_t idle = 0;
+
+        while (n < max_count && idle < participant_count) {
+            if (_turn >= participant_count)
+                _turn = 0;
+
+            auto q = _turn == 0 ? this : (*subqueues)[_turn - 1];
+
+            // Own lanes are checked anyway to call wakeup actions
+            if (q != this && q->empty()) {
+                q->_deficit = 0;
+                ++idle;
+                ++_turn;
+                continue;
+            }
+
+            if (q->_deficit == 0)
+                q->_deficit = (std::max)(q->_weight.load(), std::size_t{1});
+
+            auto quota = (std::min)(q->_deficit, max_count - n);
+
+            // Subqueues are empty, call own actions in batch
+            if (q == this && idle + 1 >= participant_count) {
+                quota = (std::max)(quota, (std::min)(max_count - n
+                    , static_cast<std::size_t>(normal_batch_size)));
+            }
+
+            auto k = q == this ? call_own(quota) : q->call_lanes(quota);
+
+            n += k;
+
+            if (k == 0) {
+                q->_deficit = 0;
+                ++idle;
+                ++_turn;
+                continue;
+            }
+
+            idle = 0;
+            q->_deficit -= (std::min)(k, q->_deficit);
+
+            if (q->_deficit == 0)
+                ++_turn;
+        }
+
+        return n;
+    }
+
+    // Checks subqueues for pending actions
+    bool subqueues_empty () const
+    {
+        if (!_has_subqueues.load())
+            return true;
+
+        std::lock_guard<std::recursive_mutex> locker(_subqueues_mtx);
+
+        for (auto q: *_subqueues) {
+            if (!q->empty())
+                return false;
+        }
+
+        return true;
+    }
+
+    template <typename F>
+    bool push_action (queue_priority priority, F && fn, discard_type && discard = nullptr)
+    {
+        auto lane = static_cast<std::size_t>(priority);
+        auto overflow = _overflow.load();
+
+        // Pending actions count before this one
+        std::size_t prev = 1;
+
+        if (!try_reserve(& prev)) {
+            switch (overflow) {
+                case overflow_policy::block:
+                    reserve_blocking(& prev);
+                    break;
+
+                case overflow_policy::drop_oldest:
+                    ++_dropped_count;
+
+                    if (push_evicting(lane, std::forward<F>(fn), discard))
+                        return true;
+
+                    // All pending actions have higher priority (or pushed
+                    // before the policy was set)
+                    if (discard)
+                        discard();
+
+                    return true;
+
+                case overflow_policy::drop_newest:
+                    ++_dropped_count;
+
+                    if (discard)
+                        discard();
+
+                    return true;
+
+                case overflow_policy::fail:
+                default:
+                    ++_rejected_count;
+                    return false;
+            }
+        }
+
+        if (overflow == overflow_policy::drop_oldest && _capacity.load() > 0)
+            push_ring(lane, std::forward<F>(fn), std::move(discard), prev == 0);
+        else
+            push_reserved(lane, std::forward<F>(fn), prev == 0);
+
+        return true;
+    }
+
+public:
+    module_queue ()
+        : _subqueues(std::make_shared<subqueue_list>())
+    {
+        for (auto & n: _lane_counts)
+            n.store(0);
+    }
+
+    ~module_queue ()
+    {
+        // Parent and subqueues can be destroyed in any order (e.g. modules
+        // destroyed by dispatcher)
+        auto parent = _parent.load();
+
+        if (parent != nullptr)
+            parent->detach_subqueue(*this);
+
+        std::lock_guard<std::recursive_mutex> locker(_subqueues_mtx);
+
+        for (auto q: *_subqueues)
+            q->_parent = nullptr;
+    }
+
+    module_queue (module_queue const &) = delete;
+    module_queue & operator = (module_queue const &) = delete;
+    module_queue (module_queue &&) = delete;
+    module_queue & operator = (module_queue &&) = delete;
+
+    /**
+     * Sets capacity (zero means unlimited) and overflow policy.
+     */
+    void set_options (queue_options const & opts)
+    {
+        _capacity = opts.capacity;
+        _overflow = opts.overflow;
+        _starvation_limit = opts.starvation_limit;
+        _weight = opts.weight;
+        _spin_time = opts.spin_time.count();
+        _yield_time = opts.yield_time.count();
+
+        // Release blocked producers if limit removed or increased
+        std::unique_lock<std::mutex> locker(_space_mtx);
+        _space_cond.notify_all();
+    }
+
+    /**
+     * Sets callback to be called after each push. Can be called while
+     * producers are pushing.
+     */
+    void set_notifier (std::function<void()> && notifier)
+    {
+        std::lock_guard<std::mutex> locker(_notifiers_mtx);
+        _notifiers.push_back(std::unique_ptr<std::function<void()>>(new std::function<void()>(std::move(notifier))));
+        _notifier.store(_notifiers.back().get(), std::memory_order_release);
+    }
+
+    queue_options options () const noexcept
+    {
+        queue_options opts;
+        opts.capacity = _capacity;
+        opts.overflow = _overflow;
+        opts.starvation_limit = _starvation_limit;
+        opts.weight = _weight;
+        opts.spin_time = std::chrono::microseconds{_spin_time.load()};
+        opts.yield_time = std::chrono::microseconds{_yield_time.load()};
+        return opts;
+    }
+
+    /**
+     * Pushes action into the lane selected by priority_scope (normal lane by
+     * default).
+     *
+     * @return @c false if action rejected by overflow_policy::fail policy,
+     *         @c true otherwise (including silently dropped action).
+     */
+    template <typename F, typename ...Args>
+    bool push (F && f, Args &&... args)
+    {
+        return push_priority(priority_scope::current_priority()
+            , std::forward<F>(f), std::forward<Args>(args)...);
+    }
+
+    /**
+     * Pushes action into the lane with specified @a priority.
+     */
+    template <typename F, typename ...Args>
+    bool push_priority (queue_priority priority, F && f, Args &&... args)
+    {
+        return push_action(priority, std::bind(std::forward<F>(f), std::forward<Args>(args)...));
+    }
+
+    /**
+     * Pushes action into the lane with specified @a priority as by
+     * push_priority(). @a discard is called instead of the action if the
+     * action is dropped by overflow policy (drop_newest or drop_oldest), so
+     * the producer can release state shared with the action. Not called if
+     * the action is rejected (@c false returned).
+     */
+    template <typename F, typename ...Args>
+    bool push_discardable (queue_priority priority, discard_type && discard
+        , F && f, Args &&... args)
+    {
+        return push_action(priority, std::bind(std::forward<F>(f), std::forward<Args>(args)...)
+            , std::move(discard));
+    }
+
+    /**
+     * Pushes action as by push_discardable(), the action is discarded
+     * (counted by expired_count() and @a discard called) if it is not called
+     * before @a deadline. deadline_clock::time_point::max() means no
+     * deadline. Used by emitter connections with the deadline of
+     * deadline_scope.
+     */
+    template <typename F, typename ...Args>
+    bool push_discardable_until (queue_priority priority, deadline_clock::time_point deadline
+        , discard_type && discard, F && f, Args &&... args)
+    {
+        if (deadline != deadline_clock::time_point::max()) {
+            return push_expiring(priority, deadline
+                , std::bind(std::forward<F>(f), std::forward<Args>(args)...)
+                , std::move(discard));
+        }
+
+        return push_action(priority, std::bind(std::forward<F>(f), std::forward<Args>(args)...)
+            , std::move(discard));
+    }
+
+    /**
+     * Pushes action to be discarded without invocation if it is not called
+     * before @a deadline. Discarded actions are counted by expired_count().
+     */
+    template <typename F, typename ...Args>
+    bool push_until (deadline_clock::time_point deadline, F && f, Args &&... args)
+    {
+        return push_expiring(priority_scope::current_priority(), deadline
+            , std::bind(std::forward<F>(f), std::forward<Args>(args)...));
+    }
+
+    /**
+     * Pushes action into the normal lane regardless of capacity and overflow
+     * policy (as wakeup()). Used for internal actions that
+     * must not be lost and may be pushed by the consumer into own queue
+     * (e.g. log records, timer callbacks). Action is counted by count() and
+     * high_water_mark(), so producers of the ordinary actions see the queue
+     * full until it is called.
+     */
+    template <typename F, typename ...Args>
+    void push_unbounded (F && f, Args &&... args)
+    {
+        auto prev = _count.fetch_add(1);
+        update_high_water_mark(prev + 1);
+        push_reserved(normal_lane, std::bind(std::forward<F>(f), std::forward<Args>(args)...)
+            , prev == 0);
+    }
+
+    /**
+     * Wakes up the consumer waiting for actions. Not limited by capacity.
+     */
+    void wakeup ()
+    {
+        // Subqueue is consumed by parent's consumer
+        auto parent = _parent.load();
+
+        if (parent != nullptr) {
+            parent->wakeup();
+            return;
+        }
+
+        push_wakeup();
+        _signaled.store(true);
+
+        notify();
+    }
+
+    /**
+     * Attaches @a q as subqueue: its actions are called by this queue's
+     * consumer in deficit round-robin manner according to subqueue weight
+     * (see queue_options::weight). Subqueue is detached on destruction of
+     * any of the queues.
+     */
+    void attach_subqueue (module_queue & q)
+    {
+        std::lock_guard<std::recursive_mutex> locker(_subqueues_mtx);
+        auto subqueues = std::make_shared<subqueue_list>(*_subqueues);
+        subqueues->push_back(& q);
+        q._parent = this;
+        _subqueues = std::move(subqueues);
+        _has_subqueues = true;
+
+        // Actions pushed before attaching
+        if (!q.empty())
+            wakeup();
+    }
+
+    void detach_subqueue (module_queue & q)
+    {
+        std::lock_guard<std::recursive_mutex> locker(_subqueues_mtx);
+        auto subqueues = std::make_shared<subqueue_list>(*_subqueues);
+        subqueues->erase(std::remove(subqueues->begin(), subqueues->end(), & q), subqueues->end());
+        q._parent = nullptr;
+        _has_subqueues = !subqueues->empty();
+        _subqueues = std::move(subqueues);
+    }
+
+    /**
+     * Checks if there are no pending actions (including subqueues' ones).
+     */
+    bool empty () const
+    {
+        return _count.load() == 0 && subqueues_empty();
+    }
+
+    /**
+     * Number of pending actions (excluding subqueues' ones).
+     */
+    std::size_t count () const noexcept
+    {
+        return _count.load();
+    }
+
+    /**
+     * Maximum number of pending actions observed.
+     */
+    std::size_t high_water_mark () const noexcept
+    {
+        return _high_water_mark.load();
+    }
+
+    /**
+     * Number of actions dropped by overflow_policy::drop_newest and
+     * overflow_policy::drop_oldest policies.
+     */
+    std::size_t dropped_count () const noexcept
+    {
+        return _dropped_count.load();
+    }
+
+    /**
+     * Number of actions discarded because of expired deadline.
+     */
+    std::size_t expired_count () const noexcept
+    {
+        return _expired_count.load();
+    }
+
+    /**
+     * Number of actions rejected by overflow_policy::fail policy.
+     */
+    std::size_t rejected_count () const noexcept
+    {
+        return _rejected_count.load();
+    }
+
+    /**
+     * Sets thread running the consumer loop, default constructed identifier
+     * resets the owner.
+     */
+    void set_owner (std::thread::id id) noexcept
+    {
+        _owner = id;
+    }
+
+    /**
+     * Checks if the current thread is the consumer of the queue: it is the
+     * owner thread or it is calling the queue actions now (e.g. worker
+     * pool thread).
+     */
+    bool is_consumer_thread () const noexcept
+    {
+        return current_consumed() == this || _owner.load() == std::this_thread::get_id()
+            || is_parent_consumer_thread();
+    }
+
+    /**
+     * Returns the topmost parent of the subqueue (the queue its actions are
+     * called from) or this queue if it is not a subqueue.
+     */
+    module_queue * root () noexcept
+    {
+        auto q = this;
+
+        for (auto parent = q->_parent.load(); parent != nullptr; parent = q->_parent.load())
+            q = parent;
+
+        return q;
+    }
+
+    module_queue const * root () const noexcept
+    {
+        return const_cast<module_queue *>(this)->root();
+    }
+
+    /**
+     * Checks if an action can be called inline instead of pushing: the
+     * current thread is the consumer of the queue and there are no pending
+     * actions in the root queue (including its subqueues), so the action
+     * would be the next one called anyway.
+     */
+    bool can_call_inline () const
+    {
+        return is_consumer_thread() && root()->empty();
+    }
+
+    /**
+     * Calls the next action: from the highest priority non-empty lane unless
+     * lower priority lane starves (see queue_options::starvation_limit).
+     */
+    std::size_t call ()
+    {
+        return call_lanes(1);
+    }
+
+    std::size_t call (int max_count)
+    {
+        return max_count > 0 ? call_lanes(static_cast<std::size_t>(max_count)) : 0;
+    }
+
+    std::size_t call_all ()
+    {
+        return call_lanes((std::numeric_limits<std::size_t>::max)());
+    }
+
+    /**
+     * Calls actions until there are no pending actions or time budget of
+     * @a microseconds is exhausted. At least one pending action is called,
+     * action being called is not interrupted.
+     */
+    std::size_t call_for (intmax_t microseconds)
+    {
+        auto deadline = deadline_clock::now() + std::chrono::microseconds{microseconds};
+        std::size_t n = 0;
+
+        do {
+            auto k = call_lanes(1);
+
+            if (k == 0)
+                break;
+
+            n += k;
+        } while (deadline_clock::now() < deadline);
+
+        return n;
+    }
+
+    /**
+     * Waits for actions according to the wait strategy (see
+     * queue_options::spin_time). Returns immediately if there are pending
+     * actions in any lane or subqueue (e.g. left by call() with limited
+     * count).
+     */
+    void wait ()
+    {
+        if (!wait_active(deadline_clock::time_point::max()))
+            _lanes[normal_lane].wait();
+    }
+
+    bool wait_for (intmax_t microseconds)
+    {
+        auto limit = deadline_clock::now() + std::chrono::microseconds{microseconds};
+
+        if (wait_active(limit))
+            return true;
+
+        auto rest = std::chrono::duration_cast<std::chrono::microseconds>(limit - deadline_clock::now());
+
+        return rest.count() > 0 && _lanes[normal_lane].wait_for(rest.count());
+    }
+};
+
+MODULUS__NAMESPACE_END
@@ -8,9 +8,71 @@
 // Changelog:
 //      2021.05.20 Initial version (inherited from https://github.com/semenovf/pfs-modulus).
 //      2023.02.09 Settings is a template parameter now (not a plugin).
+//      2026.10.17 Dispatcher and runnable modules wait for events instead of
+//                 periodic polling.
+//      2026.10.17 Function queue is a template parameter now.
+//      2026.10.17 Bounded module queues with overflow policies.
+//      2026.10.17 Runnable modules can be executed on the shared worker pool.
+//      2026.10.17 Added thread placement (CPU affinity, NUMA node, priority).
+//      2026.10.17 Timer backend is selectable per dispatcher (added timing
+//                 wheel).
+//      2026.10.17 Timers accept any duration, added fixed-rate/fixed-delay
+//                 periodic timers with missed ticks reporting.
+//      2026.10.17 Emitters and detectors are wired using API identifier index.
+//      2026.10.17 Added batch registration with deferred wiring.
+//      2026.10.17 Emitter cache is a flat table selected by ApiIdType.
+//      2026.10.17 Added payload emitter.
+//      2026.10.17 Queued detectors are grouped by target queue.
+//      2026.10.17 Added direct connection mode.
+//      2026.10.17 Added conflating emitter.
+//      2026.10.17 Added batch emitter.
+//      2026.10.17 Added module replicas and sharded detectors.
+//      2026.10.17 Added balanced detectors.
+//      2026.10.17 Added RPC emitter.
+//      2026.10.17 Added emitter with time to live.
+//      2026.10.17 Added connection priority lane.
+//      2026.10.17 Guest modules have own subqueues of the parent's queue.
+//      2026.10.17 Added time-budgeted draining and poll loop for runnable
+//                 modules.
+//      2026.10.17 Added queue wait strategy settings.
+//      2026.10.17 Added file descriptor watching (epoll reactor) for
+//                 dispatcher and runnable modules.
+//      2026.10.17 Added asynchronous file I/O service (io_uring or thread
+//                 pool).
+//      2026.10.17 Modules that may block the worker pool are rejected.
+//      2026.10.17 Fixed-rate periodic timers catch up overdue ticks.
+//      2026.10.17 Dropped or expired delivery of conflating emitter does not
+//                 stop the stream.
+//      2026.10.17 RPC callbacks of regular modules are processed from the
+//                 dispatcher's queue, timeout timer is destroyed by the
+//                 dispatcher's thread.
+//      2026.10.17 Queued detectors of guest modules are grouped by the
+//                 parent's queue.
+//      2026.10.17 Module run on worker pool can't watch file descriptors.
+//      2026.10.17 Log records and timer callbacks are not limited by capacity
+//                 of the dispatcher's queue.
+//      2026.10.17 Module overriding run() is rejected for worker pool.
+//      2026.10.17 Dropped periodic timer tick does not stop the timer.
+//      2026.10.17 Sharded and balanced detectors accept connection mode and
+//                 priority, conflating emitter is rejected for them.
+//      2026.10.17 RPC reply dropped by the caller's queue completes the call
+//                 with error.
+//      2026.10.17 Emission deadline is applied by emitter connections only.
+//      2026.10.17 Queued detectors of guest modules are grouped by own
+//                 subqueue.
 ////////////////////////////////////////////////////////////////////////////////
 #pragma once
 #include "namespace.hpp"
+#include "batch.hpp"
+#include "emitter_cache.hpp"
+#include "io_service.hpp"
+#include "module_queue.hpp"
+#include "payload.hpp"
+#include "reactor.hpp"
+#include "rpc.hpp"
+#include "thread_placement.hpp"
+#include "timer_backend.hpp"
+#include "worker_pool.hpp"
 #include <pfs/modulus/plugins/loader.hpp>
 #include <pfs/modulus/plugins/module_lifetime.hpp>
 #include <pfs/modulus/plugins/quit.hpp>
@@ -23,14 +85,24 @@
 #include <pfs/memory.hpp>
 #include <pfs/string_view.hpp>
 #include <pfs/timer_pool.hpp>
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <functional>
+#include <limits>
 #include <stdexcept>
 #include <cstddef>
+#include <cstdint>
+#include <future>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
+#include <tuple>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 MODULUS__NAMESPACE_BEGIN
 
@@ -66,17 +138,110 @@ public:
     void set (std::string const & key, char const * value) {}
 
     template <typename T>
-    T get (std::string const & key, T const & default_value) const {}
+    T get (std::string const & key, T const & default_value) const { return default_value; }
 
     template <typename T>
-    T take (std::string const & key, T const & default_value) {}
+    T take (std::string const & key, T const & default_value) { return default_value; }
 
     void remove (std::string const & key) {}
 };
 
+/**
+ * Connection mode of the detector of runnable or guest module
+ * (see module_context::connect_detector()).
+ *
+ * In connection_mode::direct mode the detector is called inline by the
+ * emitting thread if this thread is the consumer of the detector's queue
+ * (see module_queue::is_consumer_thread()) and the queue has no pending
+ * actions (for guest module: the parent's queue and all its subqueues, see
+ * module_queue::can_call_inline()). Otherwise the emission is queued as in connection_mode::queued
+ * mode, so the detector never observes the emission before actions queued
+ * earlier. Inline call is made from inside the emitter call, so the
+ * detector must not rely on the emitter's caller finishing first.
+ */
+enum class connection_mode
+{
+      queued // Emission is always pushed into the queue (default)
+    , direct // Call inline if possible
+};
+
+/**
+ * Policy of distributing emissions between balanced detectors (see
+ * module_context::connect_balanced_detector()).
+ */
+enum class balance_policy
+{
+      round_robin  // Detectors are selected in turn
+    , least_loaded // Detector with the least number of pending actions in
+                   // the queue is selected
+};
+
+/**
+ * Per-module options. Can be set by dispatcher::set_module_options() or by
+ * settings while module registration:
+ *
+ *      <module name>.queue.capacity - queue capacity (zero means unlimited);
+ *      <module name>.queue.overflow - overflow policy: "block", "drop_newest",
+ *                                     "drop_oldest" or "fail";
+ *      <module name>.queue.starvation_limit - maximum number of actions called
+ *                                     from higher priority lanes in a row;
+ *      <module name>.queue.weight - share of the parent's queue processing
+ *                                     for guest module;
+ *      <module name>.queue.spin_time - time in microseconds the consumer
+ *                                     busy-spins before yielding;
+ *      <module name>.queue.yield_time - time in microseconds the consumer
+ *                                     yields before parking;
+ *      <module name>.dedicated_thread - run module in dedicated thread even if
+ *                                     worker pool is enabled;
+ *      <module name>.cpu_set        - CPU list the module thread is allowed to
+ *                                     run on (e.g. "0-3,8");
+ *      <module name>.numa_node      - NUMA node for the module thread;
+ *      <module name>.fifo_priority  - SCHED_FIFO priority of the module thread.
+ */
+struct module_options
+{
+    // Used by runnable and guest modules (queue of the guest module is
+    // the subqueue of the parent's queue)
+    queue_options queue;
+
+    // Used by runnable modules only if dispatcher's worker pool is enabled
+    // (see dispatcher::enable_worker_pool()).
+    // NOTE! run() method is never called for module executed on the worker
+    // pool. Module that overrides it (e.g. with blocking I/O loop), module
+    // with poll loop (see runnable_module::set_poll_interval()), watching file
+    // descriptors (see runnable_module::watch_fd()) or with queue overflow
+    // policy overflow_policy::block is rejected by dispatcher::exec() unless
+    // it is run in dedicated thread. Module loaded from dynamic library is
+    // always run in dedicated thread (it is unknown whether it overrides
+    // run()).
+    bool dedicated_thread {false};
+
+    // Applied by runnable modules running in dedicated thread when the thread
+    // starts
+    placement_options placement;
+};
+
+/**
+ * Requirements for FunctionQueueType (see pfs::function_queue<> and
+ * modulus::mpsc_function_queue)
+ *
+ * class FunctionQueueType {
+ * public:
+ *      template <typename F, typename ...Args>
+ *      void push (F && f, Args &&... args);
+ *      bool empty () const;
+ *      std::size_t call ();
+ *      std::size_t call (int max_count);
+ *      std::size_t call_all ();
+ *      void wait ();
+ *      bool wait_for (intmax_t microseconds);
+ * };
+ */
+
 template <typename LoggerType
     , typename SettingsType
-    , typename ApiIdType = int>
+    , typename ApiIdType = int
+    , typename FunctionQueueType = pfs::function_queue<>>
 struct modulus
 {
     using logger_type = LoggerType;
@@ -85,11 +250,134 @@ struct modulus
     using string_type = std::string;
     using timer_id = pfs::timer_pool::timer_id;
 
+    // Periodic timer callback, receives number of ticks skipped since the
+    // previous call: overdue ticks of timer_mode::fixed_rate timer exceeding
+    // catch-up limit (see dispatcher::set_timer_catch_up_limit()), always
+    // zero for timer_mode::fixed_delay
+    using tick_callback_type = std::function<void(std::size_t /*missed*/)>;
+
     template <typename ...Args>
     using emitter_type = pfs::emitter_mt<Args...>;
     using basic_emitter_type = pfs::emitter_mt<>;
 
-    using function_queue_type = pfs::function_queue<>;
+    /**
+     * Emitter of the large messages: emitted value is moved once into the
+     * immutable shared payload, detectors receive the reference to it
+     * (detector signature is `void (payload<T>)`). Declared and connected
+     * as emitter_type<payload<T>>.
+     */
+    template <typename T>
+    class payload_emitter: public emitter_type<payload<T>>
+    {
+        using base_class = emitter_type<payload<T>>;
+
+    public:
+        using base_class::operator ();
+
+        void operator () (T && value)
+        {
+            base_class::operator () (make_payload<T>(std::move(value)));
+        }
+
+        void operator () (T const & value)
+        {
+            base_class::operator () (make_payload<T>(value));
+        }
+    };
+
+    /**
+     * Emitter of the events delivered in batches: the batch is emitted once
+     * and pushed into the queue of detectors as the single action, so
+     * emitter locking, allocation and consumer wakeup are amortized across
+     * the batch. Detector signature is `void (batch<T>)`. Declared and
+     * connected as emitter_type<batch<T>>.
+     */
+    template <typename T>
+    class batch_emitter: public emitter_type<batch<T>>
+    {
+        using base_class = emitter_type<batch<T>>;
+
+    public:
+        using base_class::operator ();
+
+        /**
+         * Emits @a events as the single batch, empty batch is not emitted.
+         */
+        void emit_batch (std::vector<T> && events)
+        {
+            if (!events.empty())
+                base_class::operator () (batch<T>{std::move(events)});
+        }
+
+        /**
+         * Emits copy of the range [@a first, @a last) as the single batch.
+         */
+        template <typename InputIt>
+        void emit_batch (InputIt first, InputIt last)
+        {
+            if (first != last)
+                base_class::operator () (batch<T>{first, last});
+        }
+
+        void emit_batch (T const * events, std::size_t count)
+        {
+            emit_batch(events, events + count);
+        }
+    };
+
+    /**
+     * Emitter with time to live (TTL) of emissions: emission queued to the
+     * detector's queue is discarded if it is not processed within TTL (see
+     * module_queue::push_discardable_until()). Zero TTL means no limit.
+     * Single emission of any emitter can be limited by deadline_scope. TTL
+     * is applied to the emissions only: actions pushed by detectors called
+     * inline (e.g. of regular modules) are not limited. Declared and
+     * connected as emitter_type<Args...>.
+     */
+    template <typename ...Args>
+    class ttl_emitter: public emitter_type<Args...>
+    {
+        using base_class = emitter_type<Args...>;
+
+        std::chrono::microseconds _ttl {0};
+
+    public:
+        template <typename Rep, typename Period>
+        void set_ttl (std::chrono::duration<Rep, Period> ttl)
+        {
+            _ttl = ceil_microseconds(ttl);
+        }
+
+        std::chrono::microseconds ttl () const noexcept
+        {
+            return _ttl;
+        }
+
+        void operator () (Args... args)
+        {
+            if (_ttl.count() > 0) {
+                deadline_scope scope {_ttl};
+                base_class::operator () (std::forward<Args>(args)...);
+            } else {
+                base_class::operator () (std::forward<Args>(args)...);
+            }
+        }
+    };
+
+    /**
+     * Emitter of the "latest value only" streams (e.g. telemetry): at most
+     * one delivery per emitter and detectors queue is pending, next emission
+     * overwrites the value of the pending delivery in place. So the slow
+     * consumer never builds a backlog. Detectors of regular modules are
+     * called directly. Declared and connected as emitter_type<Args...>.
+     * Delivery dropped by overflow policy or expired (see ttl_emitter) is
+     * replaced by the next emission.
+     */
+    template <typename ...Args>
+    class conflating_emitter: public emitter_type<Args...>
+    {};
+
+    using function_queue_type = module_queue<FunctionQueueType>;
     using module_name_type = std::pair<string_type, string_type>;
 
     using thread_pool_type = std::list<std::thread>;
@@ -110,6 +398,192 @@ struct modulus
     class runnable_module;
     class guest_module;
 
+////////////////////////////////////////////////////////////////////////////////
+// Remote procedure call
+////////////////////////////////////////////////////////////////////////////////
+    /**
+     * State of the remote procedure call shared between caller and callee.
+     * Completed once: by the first reply or by the timeout.
+     */
+    template <typename R, typename ...Args>
+    class rpc_call: public std::enable_shared_from_this<rpc_call<R, Args...>>
+    {
+    public:
+        using result_type = rpc_result<R>;
+        using callback_type = std::function<void(result_type &&)>;
+        using arguments_type = std::tuple<typename std::decay<Args>::type...>;
+
+    private:
+        arguments_type _args;
+        dispatcher * _dispatcher_ptr {nullptr};
+        function_queue_type * _callback_queue {nullptr};
+        callback_type _callback;
+        result_type _result;
+        std::atomic<bool> _completed {false};
+        std::atomic<timer_id> _timer {0};
+
+    public:
+        rpc_call (dispatcher * d, function_queue_type * callback_queue
+                , callback_type && callback, Args... args)
+            : _args(std::move(args)...)
+            , _dispatcher_ptr(d)
+            , _callback_queue(callback_queue)
+            , _callback(std::move(callback))
+        {}
+
+        arguments_type & arguments () noexcept
+        {
+            return _args;
+        }
+
+        bool completed () const noexcept
+        {
+            return _completed.load();
+        }
+
+        void set_timer (timer_id id) noexcept
+        {
+            _timer.store(id);
+        }
+
+    private:
+        // Reply is replaced by the error not limited by the queue capacity,
+        // so the callback is called exactly once from the caller's queue
+        void drop ()
+        {
+            auto self = this->shared_from_this();
+            _result = result_type{rpc_status::dropped};
+            _callback_queue->push_unbounded([self] { self->_callback(std::move(self->_result)); });
+        }
+
+    public:
+        /**
+         * Completes the call with @a result if it is not completed yet:
+         * callback is processed from the caller's queue or called directly
+         * if there is no caller's queue (see rpc_emitter::call_future()).
+         * If the reply is dropped by the caller's queue, the callback is
+         * processed from this queue with rpc_status::dropped instead.
+         */
+        void complete (result_type && result)
+        {
+            if (_completed.exchange(true))
+                return;
+
+            _result = std::move(result);
+
+            auto timer = _timer.exchange(0);
+
+            // Called from the callee's (or timer) thread, so timer is
+            // destroyed by the dispatcher's thread owning the timer backend
+            if (timer != 0) {
+                auto d = _dispatcher_ptr;
+                d->queue()->push_unbounded([d, timer] () mutable { d->destroy_timer(timer); });
+            }
+
+            if (_callback_queue != nullptr) {
+                auto self = this->shared_from_this();
+                auto accepted = _callback_queue->push_discardable(priority_scope::current_priority()
+                    , [self] { self->drop(); }
+                    , [self] { self->_callback(std::move(self->_result)); });
+
+                if (!accepted)
+                    drop();
+            } else {
+                _callback(std::move(_result));
+            }
+        }
+    };
+
+    template <typename Signature>
+    class rpc_emitter;
+
+    /**
+     * Emitter of the remote procedure call requests. Request is delivered to
+     * the detector with signature `R (Args...)` connected by
+     * module_context::connect_rpc_detector() (the first reply wins if
+     * several detectors connected). Declared by
+     * module_context::declare_emitter() as other emitters.
+     */
+    template <typename R, typename ...Args>
+    class rpc_emitter<R (Args...)>
+        : public emitter_type<std::shared_ptr<rpc_call<R, Args...>>>
+    {
+        friend class module_context;
+
+    public:
+        using call_type = rpc_call<R, Args...>;
+        using result_type = typename call_type::result_type;
+        using callback_type = typename call_type::callback_type;
+
+    private:
+        using base_class = emitter_type<std::shared_ptr<call_type>>;
+
+        dispatcher * _dispatcher_ptr {nullptr};
+        function_queue_type * _callback_queue {nullptr};
+
+    private:
+        // Regular module has no queue, callbacks are processed from the
+        // dispatcher's queue
+        void bind (dispatcher * d, function_queue_type * callback_queue)
+        {
+            _dispatcher_ptr = d;
+            _callback_queue = callback_queue != nullptr ? callback_queue : d->queue();
+        }
+
+        template <typename Rep, typename Period>
+        void call_helper (std::chrono::duration<Rep, Period> timeout
+            , function_queue_type * callback_queue
+            , callback_type && callback, Args... args)
+        {
+            assert(_dispatcher_ptr);
+
+            auto c = std::make_shared<call_type>(_dispatcher_ptr, callback_queue
+                , std::move(callback), std::move(args)...);
+
+            if (timeout.count() > 0) {
+                c->set_timer(_dispatcher_ptr->start_timer(nullptr, ceil_microseconds(timeout)
+                    , [c] { c->complete(result_type{rpc_status::timeout}); }));
+            }
+
+            base_class::operator () (std::move(c));
+        }
+
+    public:
+        /**
+         * Calls remote procedure, @a callback is processed from the caller
+         * module's queue (dispatcher's queue for regular module) when the
+         * reply received or @a timeout expired. Zero @a timeout means no
+         * timeout: if no detector is connected (or no detector replies), the
+         * callback is never called.
+         */
+        template <typename Rep, typename Period>
+        void call (std::chrono::duration<Rep, Period> timeout
+            , callback_type && callback, Args... args)
+        {
+            call_helper(timeout, _callback_queue, std::move(callback), std::move(args)...);
+        }
+
+        /**
+         * Calls remote procedure, the future is ready when the reply received
+         * or @a timeout expired. Must not be waited from the thread that
+         * processes callee's queue. With zero @a timeout the future is never
+         * ready if no detector is connected (or no detector replies).
+         */
+        template <typename Rep, typename Period>
+        std::future<result_type> call_future (std::chrono::duration<Rep, Period> timeout
+            , Args... args)
+        {
+            auto p = std::make_shared<std::promise<result_type>>();
+            auto f = p->get_future();
+
+            call_helper(timeout, nullptr, [p] (result_type && r) {
+                p->set_value(std::move(r));
+            }, std::move(args)...);
+
+            return f;
+        }
+    };
+
 ////////////////////////////////////////////////////////////////////////////////
 // Module deleter
 ////////////////////////////////////////////////////////////////////////////////
@@ -191,6 +665,11 @@ struct modulus
                            // resource identifier
         dispatcher * _dispatcher_ptr {nullptr};
 
+        // Set for module registered by dispatcher::register_replicas()
+        string_type _replica_group;
+        std::size_t _replica_index {0};
+        std::size_t _replica_count {0};
+
     protected:
         void set_dispatcher (dispatcher * pdisp) noexcept
         {
@@ -219,9 +698,29 @@ struct modulus
             _path = path;
         }
 
+        void set_replica (string_type const & group, std::size_t index, std::size_t count)
+        {
+            _replica_group = group;
+            _replica_index = index;
+            _replica_count = count;
+        }
+
         virtual void declare_emitters (module_context &)
         {}
 
+        /**
+         * Declares API identifiers the module has detectors for (see
+         * module_context::declare_detector()), so the dispatcher calls
+         * connect_detector() for corresponding emitters only.
+         * Default implementation declares that any API identifier may have
+         * a detector, so connect_detector() is called for each emitter of
+         * every registered module.
+         */
+        virtual void declare_detectors (module_context & ctx)
+        {
+            ctx.declare_any_detector();
+        }
+
         virtual bool connect_detector (api_id_type, module_context &)
         {
             // There are no detectors associated with API identifier
@@ -248,6 +747,61 @@ struct modulus
             _dispatcher_ptr->quit(status);
         }
 
+#if MODULUS__IO_SERVICE_ENABLED
+        using io_callback_type = typename basic_io_service<function_queue_type>::callback_type;
+
+        /**
+         * Reads up to @a size bytes from @a fd at @a offset (at the current
+         * file position if negative) using I/O service of the dispatcher
+         * (see dispatcher::enable_io_service()). @a callback is processed
+         * from module's queue (dispatcher's queue for regular module).
+         * @a buf must be valid until @a callback is called.
+         *
+         * @return @c false if I/O service is not enabled or operation can't be
+         *         submitted.
+         */
+        bool async_read (int fd, void * buf, std::size_t size, std::int64_t offset
+            , io_callback_type && callback)
+        {
+            auto service = _dispatcher_ptr->io_service();
+
+            return service != nullptr
+                && service->read(fd, buf, size, offset, io_callback_queue(), std::move(callback));
+        }
+
+        /**
+         * Writes @a size bytes from @a buf to @a fd at @a offset (see
+         * async_read()).
+         */
+        bool async_write (int fd, void const * buf, std::size_t size, std::int64_t offset
+            , io_callback_type && callback)
+        {
+            auto service = _dispatcher_ptr->io_service();
+
+            return service != nullptr
+                && service->write(fd, buf, size, offset, io_callback_queue(), std::move(callback));
+        }
+
+        /**
+         * Flushes @a fd after all previously submitted operations complete
+         * (see async_read()).
+         */
+        bool async_fsync (int fd, io_callback_type && callback, bool data_only = false)
+        {
+            auto service = _dispatcher_ptr->io_service();
+
+            return service != nullptr
+                && service->fsync(fd, data_only, io_callback_queue(), std::move(callback));
+        }
+
+    private:
+        function_queue_type * io_callback_queue () const
+        {
+            auto q = this->queue();
+            return q != nullptr ? q : _dispatcher_ptr->queue();
+        }
+#endif
+
     public:
         virtual ~basic_module () {}
 
@@ -261,6 +815,28 @@ struct modulus
             return _path;
         }
 
+        /**
+         * Name of the replica group (see dispatcher::register_replicas()),
+         * empty if module is not a replica.
+         */
+        string_type const & replica_group () const noexcept
+        {
+            return _replica_group;
+        }
+
+        std::size_t replica_index () const noexcept
+        {
+            return _replica_index;
+        }
+
+        /**
+         * Number of replicas in the group, zero if module is not a replica.
+         */
+        std::size_t replica_count () const noexcept
+        {
+            return _replica_count;
+        }
+
         virtual runnable_interface * runnable () { return nullptr; }
 
         // Returns true if module is guest (if the module is runnable or
@@ -317,14 +893,16 @@ struct modulus
 
         /**
          * Used to enqueue an action into own queue for later processing.
+         *
+         * @return @c false if action rejected by the queue overflow policy.
          */
         template <typename F, typename ...Args>
-        void enqueue (F && f, Args &&... args)
+        bool enqueue (F && f, Args &&... args)
         {
             auto * q = this->queue();
 
             if (q)
-                q->push(std::forward<F>(f), std::forward<Args>(args)...);
+                return q->push(std::forward<F>(f), std::forward<Args>(args)...);
             else
                 throw std::runtime_error(tr::_("enqueue action into a module without a queue is prohibited"));
         }
@@ -360,12 +938,23 @@ struct modulus
     ////////////////////////////////////////////////////////////////////////////
     class module_context
     {
-        using emitter_cache_type = std::map<api_id_type, basic_emitter_type *>;
+        using emitter_cache_type = emitter_cache<api_id_type, basic_emitter_type>;
 
         dispatcher *       _dispatcher_ptr {nullptr};
         module_pointer     _module_ptr;
         string_type        _parent_name;
         emitter_cache_type _emitter_cache;
+        module_options     _options;
+
+        // API identifiers the module has detectors for
+        std::vector<api_id_type> _detector_ids;
+
+        // API identifiers of conflating emitters
+        std::vector<api_id_type> _conflating_ids;
+        bool _any_detector {false};
+
+        // Module is registered but not wired yet
+        bool _wiring_pending {false};
 
     public:
         using map_type = std::map<string_type, module_context>;
@@ -397,6 +986,7 @@ struct modulus
 
             _dispatcher_ptr->log_trace(tr::f_("Declare emitters for module: {}", this->name()));
             _module_ptr->declare_emitters(*this);
+            _module_ptr->declare_detectors(*this);
         }
 
         string_type const & name () const
@@ -419,6 +1009,11 @@ struct modulus
             return & *_module_ptr;
         }
 
+        module_options const & options () const
+        {
+            return _options;
+        }
+
         /**
          * Must be invoked from module's declare_emitters() overloaded method
          * for declaring specified by @a id module's emitter.
@@ -430,25 +1025,73 @@ struct modulus
             _emitter_cache.emplace(id, reinterpret_cast<basic_emitter_type *>(& em));
         }
 
+        template <typename R, typename ...Args>
+        void declare_emitter (api_id_type id, rpc_emitter<R (Args...)> & em)
+        {
+            em.bind(_dispatcher_ptr, _module_ptr->queue());
+            declare_emitter(id, static_cast<emitter_type<std::shared_ptr<rpc_call<R, Args...>>> &>(em));
+        }
+
+        template <typename ...Args>
+        void declare_emitter (api_id_type id, conflating_emitter<Args...> & em)
+        {
+            static_assert(std::is_copy_assignable<std::tuple<typename std::decay<Args>::type...>>::value
+                , "arguments of conflating emitter must be copy assignable");
+
+            declare_emitter(id, static_cast<emitter_type<Args...> &>(em));
+
+            if (std::find(_conflating_ids.begin(), _conflating_ids.end(), id) == _conflating_ids.end())
+                _conflating_ids.push_back(id);
+        }
+
+        /**
+         * Must be invoked from module's declare_detectors() overloaded method
+         * for declaring module's detector for specified by @a id API.
+         */
+        void declare_detector (api_id_type id)
+        {
+            if (std::find(_detector_ids.begin(), _detector_ids.end(), id) == _detector_ids.end())
+                _detector_ids.push_back(id);
+        }
+
+        /**
+         * Declares that module may have detector for any API.
+         */
+        void declare_any_detector ()
+        {
+            _any_detector = true;
+        }
+
         /**
          * Must be invoked from module's connect_detectors() overloaded method
          * for connecting specified by @a id module's detector.
          *
+         * @param mode Connection mode, ignored for regular module.
+         * @param priority Queue lane for emissions, ignored for regular module.
+         *        For queue_priority::normal the lane selected by emitting
+         *        thread's priority_scope is used.
+         *
          * @return @c true if emitter with associated API identifier @a id found
          *         and connected to detector, @c false if otherwise.
          */
         template <typename ModuleClass, typename ...Args>
-        bool connect_detector (api_id_type id, ModuleClass & m, void (ModuleClass::*f) (Args...))
+        bool connect_detector (api_id_type id, ModuleClass & m, void (ModuleClass::*f) (Args...)
+            , connection_mode mode = connection_mode::queued
+            , queue_priority priority = queue_priority::normal)
         {
-            auto it = _emitter_cache.find(id);
+            auto cached = _emitter_cache.find(id);
+
+            if (cached != nullptr) {
+                auto em = reinterpret_cast<emitter_type<Args...> *>(cached);
 
-            if (it != _emitter_cache.end()) {
-                auto em = reinterpret_cast<emitter_type<Args...> *>(it->second);
+                auto d = [pm = & m, f] (Args... args) {
+                    (pm->*f)(std::forward<Args>(args)...);
+                };
 
                 if (m.queue())
-                    em->connect(*m.queue(), m, f);
+                    connect_queued(id, *em, *m.queue(), mode, priority, d);
                 else
-                    em->connect(m, f);
+                    em->connect(inline_detector(d));
 
                 return true;
             }
@@ -466,20 +1109,22 @@ struct modulus
         };
 
         template <typename ModuleClass, typename F>
-        bool connect_detector (api_id_type id, ModuleClass & m, F f)
+        bool connect_detector (api_id_type id, ModuleClass & m, F f
+            , connection_mode mode = connection_mode::queued
+            , queue_priority priority = queue_priority::normal)
         {
-            auto it = _emitter_cache.find(id);
+            auto cached = _emitter_cache.find(id);
 
-            if (it != _emitter_cache.end()) {
+            if (cached != nullptr) {
                 using emitter_traits = __emitter_traits<F>;
 
-                auto em = reinterpret_cast<typename emitter_traits::type *>(it->second);
+                auto em = reinterpret_cast<typename emitter_traits::type *>(cached);
                 auto q = m.queue();
 
                 if (q != nullptr)
-                    em->connect(*q, f);
+                    connect_queued(id, *em, *q, mode, priority, f);
                 else
-                    em->connect(f);
+                    em->connect(inline_detector(f));
 
                 return true;
             }
@@ -487,58 +1132,552 @@ struct modulus
             return false;
         }
 
-    private:
-        friend class dispatcher;
-
-        void connect_emitters (typename map_type::iterator first, typename map_type::iterator last)
+        /**
+         * Connects remote procedure with signature `R (Args...)` as detector
+         * of the rpc_emitter<R (Args...)> with identifier @a id. Returned
+         * value is replied to the caller.
+         */
+        template <typename ModuleClass, typename R, typename ...Args>
+        bool connect_rpc_detector (api_id_type id, ModuleClass & m
+            , R (ModuleClass::*f) (Args...)
+            , connection_mode mode = connection_mode::queued
+            , queue_priority priority = queue_priority::normal)
         {
-            _dispatcher_ptr->log_trace(tr::_("Connecting emitters:"));
+            using call_pointer = std::shared_ptr<rpc_call<R, Args...>>;
 
-            // Connecting emitters of this module with corresponding detectors
-            // of modules in range [first; last) and with own detectors
-            for (auto & em: _emitter_cache) {
-                auto id = em.first;
+            auto cached = _emitter_cache.find(id);
 
-                // Connect with own detector
-                if (_module_ptr->connect_detector(id, *this)) {
-                    trace_emitter_connected(id, _module_ptr->name(), _module_ptr->name());
-                }
+            if (cached == nullptr)
+                return false;
 
-                for (typename map_type::iterator it = first; it != last; ++it) {
-                    if (it->second._module_ptr->connect_detector(id, *this)) {
-                        trace_emitter_connected(id, _module_ptr->name(), it->second.name());
-                    }
-                }
-            }
+            auto em = reinterpret_cast<emitter_type<call_pointer> *>(cached);
+            auto handler = [pm = & m, f] (call_pointer c) {
+                // Already replied by other detector or timed out
+                if (c->completed())
+                    return;
 
-            // Connecting emitters of modules in range [first; last)
-            // with corresponding detectors of this module
-            for (typename map_type::iterator it = first; it != last; ++it) {
-                for (auto & em: it->second._emitter_cache) {
-                    auto id = em.first;
+                c->complete(invoke_rpc(pm, f, c->arguments()
+                    , std::index_sequence_for<Args...>{}, std::is_void<R>{}));
+            };
 
-                    if (_module_ptr->connect_detector(id, it->second)) {
-                        trace_emitter_connected(id, it->second.name(), _module_ptr->name());
-                    }
-                }
-            }
+            if (m.queue())
+                connect_queued(id, *em, *m.queue(), mode, priority, handler);
+            else
+                em->connect(inline_detector(handler));
+
+            return true;
         }
 
-    public:
-        void disconnect_emitters ()
+        /**
+         * Connects detector of the module replica (see
+         * dispatcher::register_replicas()): each emission is delivered to
+         * exactly one replica of the group selected by hash of the key.
+         * Emissions with equal keys are delivered to the same replica in
+         * emission order. Detector of not replicated module is connected as
+         * by connect_detector().
+         *
+         * Each emission is pushed as a separate action (not grouped with
+         * other detectors sharing the replica's queue). Emitter of the
+         * replicated module can't be conflating_emitter (coalescing would mix
+         * emissions with different keys): connection fails.
+         *
+         * @param key_fn Key extractor with signature `K (Args const &...)`,
+         *        K must be hashable by std::hash<K>.
+         * @param mode Connection mode, see connect_detector().
+         * @param priority Queue lane for emissions, see connect_detector().
+         */
+        template <typename ModuleClass, typename KeyFn, typename ...Args>
+        bool connect_sharded_detector (api_id_type id, ModuleClass & m
+            , void (ModuleClass::*f) (Args...), KeyFn key_fn
+            , connection_mode mode = connection_mode::queued
+            , queue_priority priority = queue_priority::normal)
         {
-            for (auto & em: _emitter_cache) {
-                em.second->disconnect_all();
-            }
+            if (m.replica_count() == 0)
+                return connect_detector(id, m, f, mode, priority);
 
-            _dispatcher_ptr->log_trace(tr::f_("emitters disconnected for [{}]", _module_ptr->name()));
-        }
+            auto cached = _emitter_cache.find(id);
 
-    }; // module_context
+            if (cached == nullptr || !check_distributable(id, m))
+                return false;
 
-    ////////////////////////////////////////////////////////////////////////////
-    // dispatcher
-    ////////////////////////////////////////////////////////////////////////////
+            auto em = reinterpret_cast<emitter_type<Args...> *>(cached);
+            auto key = std::make_tuple(id, m.replica_group(), false);
+            auto pos = _distribution_groups.find(key);
+            distribution_group<Args...> * group = nullptr;
+
+            if (pos != _distribution_groups.end()) {
+                group = static_cast<distribution_group<Args...> *>(pos->second.get());
+            } else {
+                auto g = std::make_shared<distribution_group<Args...>>(m.replica_count()
+                    , [key_fn] (Args const &... args) {
+                        auto k = key_fn(args...);
+                        return std::hash<decltype(k)>{}(k);
+                    });
+
+                em->connect([g] (Args... args) { (*g)(args...); });
+                group = g.get();
+                _distribution_groups.emplace(key, std::move(g));
+            }
+
+            group->set(m.replica_index(), m.queue(), mode, priority, [pm = & m, f] (Args... args) {
+                (pm->*f)(std::forward<Args>(args)...);
+            });
+
+            return true;
+        }
+
+        /**
+         * Connects detector to the pool of balanced detectors of the emitter:
+         * each emission is delivered to exactly one detector of the pool
+         * selected according to @a policy (policy of the first connected
+         * detector is used). Pool consists of the replicas of the same group
+         * (see dispatcher::register_replicas()) or of all not replicated
+         * modules connected by this method. Use for stateless processing
+         * only, there is no ordering between emissions delivered to different
+         * detectors.
+         *
+         * As for connect_sharded_detector() each emission is pushed as a
+         * separate action and conflating_emitter can't be connected.
+         *
+         * @param mode Connection mode, see connect_detector().
+         * @param priority Queue lane for emissions, see connect_detector().
+         */
+        template <typename ModuleClass, typename ...Args>
+        bool connect_balanced_detector (api_id_type id, ModuleClass & m
+            , void (ModuleClass::*f) (Args...)
+            , balance_policy policy = balance_policy::round_robin
+            , connection_mode mode = connection_mode::queued
+            , queue_priority priority = queue_priority::normal)
+        {
+            auto cached = _emitter_cache.find(id);
+
+            if (cached == nullptr || !check_distributable(id, m))
+                return false;
+
+            auto em = reinterpret_cast<emitter_type<Args...> *>(cached);
+            auto key = std::make_tuple(id, m.replica_group(), true);
+            auto pos = _distribution_groups.find(key);
+            distribution_group<Args...> * group = nullptr;
+
+            if (pos != _distribution_groups.end()) {
+                group = static_cast<distribution_group<Args...> *>(pos->second.get());
+            } else {
+                auto g = std::make_shared<distribution_group<Args...>>(policy);
+                em->connect([g] (Args... args) { (*g)(args...); });
+                group = g.get();
+                _distribution_groups.emplace(key, std::move(g));
+            }
+
+            group->add(m.queue(), mode, priority, [pm = & m, f] (Args... args) {
+                (pm->*f)(std::forward<Args>(args)...);
+            });
+
+            return true;
+        }
+
+    private:
+        friend class dispatcher;
+
+        /**
+         * Queued detectors of the emitter sharing the same queue and connection
+         * mode: emit pushes the single action calling all of them in
+         * connection order (or calls them inline, see connection_mode::direct).
+         * Group of conflating emitter keeps at most one pending action.
+         */
+        template <typename ...Args>
+        class fanout_group: public std::enable_shared_from_this<fanout_group<Args...>>
+        {
+        public:
+            using detector_type = std::function<void(Args...)>;
+
+        private:
+            using list_type = std::vector<detector_type>;
+            using value_type = std::tuple<typename std::decay<Args>::type...>;
+            using conflatable = std::is_copy_assignable<value_type>;
+
+            struct conflation_slot
+            {
+                std::mutex mtx;
+                std::unique_ptr<value_type> latest;    // Overwritten by emitter
+                std::unique_ptr<value_type> delivered; // Swapped with latest by consumer
+                bool pending {false};
+            };
+
+            function_queue_type * _q {nullptr};
+            bool _direct {false};
+            queue_priority _priority {queue_priority::normal};
+            std::unique_ptr<conflation_slot> _slot;
+
+            // Copy-on-write list, so wiring does not block emitting
+            std::shared_ptr<list_type const> _detectors;
+
+        private:
+            // Lane of the connection overrides lane selected by emitter
+            queue_priority priority () const
+            {
+                return _priority == queue_priority::normal
+                    ? priority_scope::current_priority() : _priority;
+            }
+
+            // Dropped or expired delivery releases the slot
+            void release_slot ()
+            {
+                std::unique_lock<std::mutex> locker(_slot->mtx);
+                _slot->pending = false;
+            }
+
+            void call_inline (list_type const & detectors, Args &... args)
+            {
+                deadline_scope scope {deadline_scope::none{}};
+
+                for (auto & d: detectors)
+                    d(args...);
+            }
+
+            // Returns false if emission must be queued as usual
+            bool conflate (std::false_type, Args &...)
+            {
+                return false;
+            }
+
+            bool conflate (std::true_type, Args &... args)
+            {
+                {
+                    std::unique_lock<std::mutex> locker(_slot->mtx);
+
+                    if (!_slot->pending && _direct && _q->can_call_inline()) {
+                        locker.unlock();
+                        call_inline(*std::atomic_load(& _detectors), args...);
+                        return true;
+                    }
+
+                    // Buffers are allocated by first two emissions only
+                    if (_slot->latest)
+                        *_slot->latest = std::tie(args...);
+                    else
+                        _slot->latest = pfs::make_unique<value_type>(args...);
+
+                    if (_slot->pending)
+                        return true;
+
+                    _slot->pending = true;
+                }
+
+                auto self = this->shared_from_this();
+
+                // Deadline of the emission (see ttl_emitter)
+                if (!_q->push_discardable_until(priority(), deadline_scope::current_deadline()
+                        , [self] { self->release_slot(); }
+                        , [self] { self->deliver(std::index_sequence_for<Args...>{}); })) {
+                    release_slot();
+                }
+
+                return true;
+            }
+
+            template <std::size_t ...I>
+            void deliver (std::index_sequence<I...>)
+            {
+                {
+                    std::unique_lock<std::mutex> locker(_slot->mtx);
+                    std::swap(_slot->latest, _slot->delivered);
+                    _slot->pending = false;
+                }
+
+                auto detectors = std::atomic_load(& _detectors);
+
+                for (auto & d: *detectors)
+                    d(std::get<I>(*_slot->delivered)...);
+            }
+
+        public:
+            fanout_group (function_queue_type & q, connection_mode mode
+                    , queue_priority priority, bool conflating)
+                : _q(& q)
+                , _direct(mode == connection_mode::direct)
+                , _priority(priority)
+                , _detectors(std::make_shared<list_type>())
+            {
+                if (conflating && conflatable::value)
+                    _slot = pfs::make_unique<conflation_slot>();
+            }
+
+            void add (detector_type && d)
+            {
+                auto detectors = std::make_shared<list_type>(*std::atomic_load(& _detectors));
+                detectors->push_back(std::move(d));
+                std::atomic_store(& _detectors, std::shared_ptr<list_type const>{std::move(detectors)});
+            }
+
+            void operator () (Args... args)
+            {
+                if (_slot && conflate(conflatable{}, args...))
+                    return;
+
+                auto detectors = std::atomic_load(& _detectors);
+
+                if (_direct && _q->can_call_inline()) {
+                    call_inline(*detectors, args...);
+                    return;
+                }
+
+                _q->push_discardable_until(priority(), deadline_scope::current_deadline(), nullptr
+                    , [detectors] (auto &... a) {
+                        for (auto & d: *detectors)
+                            d(a...);
+                    }, args...);
+            }
+        };
+
+        /**
+         * Detectors connected to the emitter each emission is delivered to
+         * exactly one of: selected by key hash (sharded group, indexed by
+         * replica index) or by balance policy.
+         */
+        template <typename ...Args>
+        class distribution_group
+        {
+        public:
+            using detector_type = std::function<void(Args...)>;
+            using hash_function_type = std::function<std::size_t(Args const &...)>;
+
+        private:
+            struct target
+            {
+                function_queue_type * q {nullptr}; // nullptr for regular module
+                bool direct {false};
+                queue_priority priority {queue_priority::normal};
+                detector_type d;
+            };
+
+            using list_type = std::vector<target>;
+
+            hash_function_type _hash; // Sharded group only
+            balance_policy _policy {balance_policy::round_robin};
+            std::atomic<std::size_t> _next {0};
+
+            // Copy-on-write list, so wiring does not block emitting
+            std::shared_ptr<list_type const> _targets;
+
+        private:
+            static void set_target (target & t, function_queue_type * q, connection_mode mode
+                , queue_priority priority, detector_type && d)
+            {
+                t.q = q;
+                t.direct = (mode == connection_mode::direct);
+                t.priority = priority;
+                t.d = std::move(d);
+            }
+
+            std::size_t select (list_type const & targets, Args const &... args)
+            {
+                auto n = targets.size();
+
+                if (_hash)
+                    return _hash(args...) % n;
+
+                auto index = _next.fetch_add(1, std::memory_order_relaxed) % n;
+
+                if (_policy == balance_policy::round_robin)
+                    return index;
+
+                // Scan starts from the next detector in turn, so ties are
+                // resolved in round-robin manner
+                auto best = index;
+                auto best_count = (std::numeric_limits<std::size_t>::max)();
+
+                for (std::size_t i = 0; i < n && best_count > 0; i++, index = (index + 1) % n) {
+                    auto const & t = targets[index];
+
+                    if (!t.d)
+                        continue;
+
+                    auto count = t.q != nullptr ? t.q->count() : 0;
+
+                    if (count < best_count) {
+                        best = index;
+                        best_count = count;
+                    }
+                }
+
+                return best;
+            }
+
+        public:
+            distribution_group (std::size_t count, hash_function_type && hash)
+                : _hash(std::move(hash))
+                , _targets(std::make_shared<list_type>(count))
+            {}
+
+            distribution_group (balance_policy policy)
+                : _policy(policy)
+                , _targets(std::make_shared<list_type>())
+            {}
+
+            void set (std::size_t index, function_queue_type * q, connection_mode mode
+                , queue_priority priority, detector_type && d)
+            {
+                auto targets = std::make_shared<list_type>(*std::atomic_load(& _targets));
+
+                if (index >= targets->size())
+                    targets->resize(index + 1);
+
+                set_target((*targets)[index], q, mode, priority, std::move(d));
+                std::atomic_store(& _targets, std::shared_ptr<list_type const>{std::move(targets)});
+            }
+
+            void add (function_queue_type * q, connection_mode mode, queue_priority priority
+                , detector_type && d)
+            {
+                auto targets = std::make_shared<list_type>(*std::atomic_load(& _targets));
+                targets->emplace_back();
+                set_target(targets->back(), q, mode, priority, std::move(d));
+                std::atomic_store(& _targets, std::shared_ptr<list_type const>{std::move(targets)});
+            }
+
+            void operator () (Args... args)
+            {
+                auto targets = std::atomic_load(& _targets);
+                auto n = targets->size();
+
+                if (n == 0)
+                    return;
+
+                auto index = select(*targets, args...);
+
+                // Skip replicas not connected (e.g. failed to register)
+                for (std::size_t i = 0; i < n; i++, index = (index + 1) % n) {
+                    auto & t = (*targets)[index];
+
+                    if (!t.d)
+                        continue;
+
+                    if (t.q == nullptr || (t.direct && t.q->can_call_inline())) {
+                        deadline_scope scope {deadline_scope::none{}};
+                        t.d(args...);
+                        return;
+                    }
+
+                    // Lane of the connection overrides lane selected by
+                    // emitter, deadline of the emission (see ttl_emitter)
+                    auto priority = t.priority == queue_priority::normal
+                        ? priority_scope::current_priority() : t.priority;
+
+                    t.q->push_discardable_until(priority, deadline_scope::current_deadline(), nullptr
+                        , [targets, index] (auto &... a) {
+                            (*targets)[index].d(a...);
+                        }, args...);
+
+                    return;
+                }
+            }
+        };
+
+        // Distribution groups of module's emitters by API identifier, replica
+        // group and flag of balanced group
+        std::map<std::tuple<api_id_type, string_type, bool>, std::shared_ptr<void>> _distribution_groups;
+
+        using fanout_key_type = std::tuple<api_id_type, function_queue_type *
+            , connection_mode, queue_priority>;
+
+        // Fan-out groups of module's emitters
+        std::map<fanout_key_type, std::shared_ptr<void>> _fanout_groups;
+
+        // Detector of the regular module is called inline from the emission,
+        // so actions it pushes are not limited by the emission deadline (see
+        // ttl_emitter)
+        template <typename F>
+        static auto inline_detector (F f)
+        {
+            return [f] (auto &&... args) mutable {
+                deadline_scope scope {deadline_scope::none{}};
+                f(std::forward<decltype(args)>(args)...);
+            };
+        }
+
+        // Emissions to detectors of the guest module are pushed into its
+        // subqueue, so they are covered by the guest's fairness share,
+        // capacity and statistics (one action per emission for each guest)
+        template <typename ...Args>
+        void connect_queued (api_id_type id, emitter_type<Args...> & em
+            , function_queue_type & q, connection_mode mode, queue_priority priority
+            , typename fanout_group<Args...>::detector_type && d)
+        {
+            auto key = std::make_tuple(id, & q, mode, priority);
+            auto pos = _fanout_groups.find(key);
+
+            if (pos != _fanout_groups.end()) {
+                static_cast<fanout_group<Args...> *>(pos->second.get())->add(std::move(d));
+                return;
+            }
+
+            auto conflating = std::find(_conflating_ids.begin(), _conflating_ids.end(), id)
+                != _conflating_ids.end();
+            auto group = std::make_shared<fanout_group<Args...>>(q, mode, priority, conflating);
+            group->add(std::move(d));
+            em.connect([group] (Args... args) { (*group)(args...); });
+            _fanout_groups.emplace(key, std::move(group));
+        }
+
+        // Emissions of conflating emitter can't be distributed between
+        // detectors (see connect_sharded_detector())
+        bool check_distributable (api_id_type id, basic_module const & m)
+        {
+            if (std::find(_conflating_ids.begin(), _conflating_ids.end(), id) == _conflating_ids.end())
+                return true;
+
+            _dispatcher_ptr->log_error(tr::f_("conflating emitter [{}] of module [{}] can't be"
+                " connected to sharded or balanced detector of module [{}]"
+                , id, _module_ptr->name(), m.name()));
+
+            return false;
+        }
+
+        template <typename ModuleClass, typename R, typename ...Args, typename Tuple, std::size_t ...I>
+        static rpc_result<R> invoke_rpc (ModuleClass * m, R (ModuleClass::*f) (Args...)
+            , Tuple & args, std::index_sequence<I...>, std::false_type)
+        {
+            return rpc_result<R>{(m->*f)(std::get<I>(args)...)};
+        }
+
+        template <typename ModuleClass, typename R, typename ...Args, typename Tuple, std::size_t ...I>
+        static rpc_result<R> invoke_rpc (ModuleClass * m, R (ModuleClass::*f) (Args...)
+            , Tuple & args, std::index_sequence<I...>, std::true_type)
+        {
+            (m->*f)(std::get<I>(args)...);
+            return rpc_result<R>{rpc_status::success};
+        }
+
+        bool connect_detector_of (module_context & ectx, api_id_type id, bool trace = true)
+        {
+            if (_module_ptr->connect_detector(id, ectx)) {
+                if (trace)
+                    trace_emitter_connected(id, ectx.name(), name());
+
+                return true;
+            }
+
+            return false;
+        }
+
+    public:
+        void disconnect_emitters ()
+        {
+            for (auto & em: _emitter_cache) {
+                em.second->disconnect_all();
+            }
+
+            _fanout_groups.clear();
+            _distribution_groups.clear();
+
+            _dispatcher_ptr->log_trace(tr::f_("emitters disconnected for [{}]", _module_ptr->name()));
+        }
+
+    }; // module_context
+
+    ////////////////////////////////////////////////////////////////////////////
+    // dispatcher
+    ////////////////////////////////////////////////////////////////////////////
     class dispatcher final
     {
         friend class basic_module;
@@ -546,10 +1685,28 @@ struct modulus
         friend class runnable_module;
         friend class guest_module;
 
+        template <typename R, typename ...Args>
+        friend class rpc_call;
+
+        template <typename Signature>
+        friend class rpc_emitter;
+
         using timer_pool_type = pfs::timer_pool;
+        using timer_backend_type = basic_timer_backend<function_queue_type>;
+#if MODULUS__IO_SERVICE_ENABLED
+        using io_service_type = basic_io_service<function_queue_type>;
+#endif
         using string_type = modulus::string_type;
         using module_context_map_type = typename module_context::map_type;
         using thread_pool_type = std::list<std::thread>;
+        using strand_type = strand<function_queue_type>;
+
+        struct pooled_runnable
+        {
+            string_type name;
+            exit_status status;
+            std::unique_ptr<strand_type> strand_ptr;
+        };
 
     ////////////////////////////////////////////////////////////////////////////
     // Plugins' specific data, signals and slots
@@ -569,12 +1726,37 @@ struct modulus
         ////////////////////////////////////////////////////////////////////////
         std::vector<loader_plugin<modulus> *> _loaders;
 
-        mutable function_queue_type      _q;
-        std::unique_ptr<timer_pool_type> _timer_pool_ptr;
-        module_context_map_type          _module_specs;
-
-        intmax_t _wait_period {500000}; // wait period in microseconds
-                                       // (default is 500 milliseconds)
+#if MODULUS__REACTOR_ENABLED
+        // Created by the first watch_fd() call. Outlives the queue, which
+        // notifies it.
+        std::unique_ptr<reactor>            _reactor;
+#endif
+
+        mutable function_queue_type         _q;
+        std::unique_ptr<timer_backend_type> _timer_pool_ptr;
+        module_context_map_type             _module_specs;
+
+        // API identifier index for wiring emitters and detectors
+        using context_list_type = std::vector<module_context *>;
+        std::map<api_id_type, context_list_type> _emitter_index;
+        std::map<api_id_type, context_list_type> _detector_index;
+        context_list_type _any_detector_modules; // Modules not declared detectors
+
+        // Modules registered after begin_batch() and not wired yet
+        bool _batch_active {false};
+        context_list_type _pending_wiring;
+
+        timer_backend _timer_backend {timer_backend::timer_pool};
+        std::chrono::microseconds _timer_resolution {std::chrono::milliseconds{1}};
+        std::size_t _timer_catch_up_limit {8};
+
+#if MODULUS__IO_SERVICE_ENABLED
+        // Asynchronous file I/O service (see enable_io_service())
+        bool _io_service_enabled {false};
+        io_backend _io_backend {io_backend::io_uring};
+        std::size_t _io_thread_count {1};
+        std::unique_ptr<io_service_type> _io_service_ptr;
+#endif
 
         std::atomic_int _quit_flag {0};
 
@@ -583,6 +1765,16 @@ struct modulus
         std::shared_ptr<logger_type> _logger;
         settings_type _settings;
 
+        // Placement of the dispatcher thread
+        placement_options _placement;
+
+        // Worker pool for runnable modules that do not require dedicated
+        // thread (M:N execution mode)
+        bool _worker_pool_enabled {false};
+        std::size_t _worker_pool_size {0};
+        std::unique_ptr<worker_pool> _worker_pool_ptr;
+        std::list<pooled_runnable> _pooled_runnables;
+
         // If true, the dispatcher ignores modules that return false in the on_start() method.
         // Main runnable module cannot be ignored.
         bool _ignore_module_on_start_failure {false};
@@ -595,22 +1787,139 @@ struct modulus
         char ** _argv {nullptr};
 
     private:
-        struct timer_callback_helper
+        struct periodic_timer_state
         {
-            pfs::timer_pool::callback_type callback;
+            dispatcher * d {nullptr};
             function_queue_type * callback_queue {nullptr};
-            pfs::timer_pool::timer_id timerid {0};
-
-            void operator () ()
+            tick_callback_type callback;
+            timer_mode mode {timer_mode::fixed_rate};
+            std::chrono::microseconds period;
+            std::chrono::steady_clock::time_point start;
+            std::atomic<timer_id> id {0};
+
+            // Maximum number of overdue ticks delivered in burst
+            std::size_t catch_up_limit {0};
+
+            // Set by destroy_timer(), stops catch-up burst and ignores
+            // queued tick
+            std::atomic_bool cancelled {false};
+
+            // Tick is queued but not processed yet
+            std::atomic_bool pending {false};
+            std::int64_t last_tick {0};
+
+            // Set by the first of start_periodic_timer() (identifier is
+            // stored) and fixed-delay tick processed before the identifier
+            // is stored, the second one resumes the timer
+            std::atomic_bool resume_deferred {false};
+
+            // Called from the timer thread
+            static void fire (std::shared_ptr<periodic_timer_state> const & st)
             {
-                if (callback_queue) {
-                    callback_queue->push(callback);
+                // Ticks expired while previous one is pending are counted by
+                // the next call (see process())
+                if (st->pending.exchange(true))
+                    return;
+
+                if (st->callback_queue) {
+                    auto accepted = st->callback_queue->push_discardable(queue_priority::normal
+                        , [st] { discard(st); }
+                        , [st] { process(st); });
+
+                    if (!accepted)
+                        discard(st);
                 } else {
-                    callback();
+                    process(st);
                 }
             }
+
+            // Tick dropped or rejected by the callback queue
+            static void discard (std::shared_ptr<periodic_timer_state> const & st)
+            {
+                st->pending.store(false);
+
+                if (st->mode == timer_mode::fixed_delay)
+                    resume(st);
+            }
+
+            static void resume (std::shared_ptr<periodic_timer_state> const & st)
+            {
+                auto id = st->id.load();
+
+                if (id == 0) {
+                    if (!st->resume_deferred.exchange(true))
+                        return;
+
+                    id = st->id.load();
+                }
+
+                st->d->resume_timer(id);
+            }
+
+            static void process (std::shared_ptr<periodic_timer_state> const & st)
+            {
+                std::size_t calls = 1;
+                std::size_t missed = 0;
+
+                if (st->mode == timer_mode::fixed_rate) {
+                    // Number of the nearest tick according to the schedule
+                    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::steady_clock::now() - st->start);
+                    std::int64_t tick = (elapsed + st->period / 2) / st->period;
+
+                    // Overdue ticks are called in burst (bounded), the rest
+                    // are skipped
+                    if (tick > st->last_tick) {
+                        auto due = static_cast<std::size_t>(tick - st->last_tick);
+                        calls = (std::min)(due, st->catch_up_limit + 1);
+                        missed = due - calls;
+                        st->last_tick = tick;
+                    }
+                }
+
+                st->pending.store(false);
+
+                for (std::size_t i = 0; i < calls && !st->cancelled.load(); i++)
+                    st->callback(i == 0 ? missed : 0);
+
+                if (st->mode == timer_mode::fixed_delay)
+                    resume(st);
+            }
         };
 
+        // Periodic timers by identifier (to cancel queued ticks and catch-up
+        // bursts, see destroy_timer())
+        std::mutex _periodic_timers_mtx;
+        std::map<timer_id, std::weak_ptr<periodic_timer_state>> _periodic_timers;
+
+#if MODULUS__IO_SERVICE_ENABLED
+        void open_io_service ()
+        {
+#   if MODULUS__IO_URING_ENABLED
+            if (_io_backend == io_backend::io_uring) {
+                auto service = pfs::make_unique<io_uring_service<function_queue_type>>();
+                auto err = service->open();
+
+                if (err.empty()) {
+                    _io_service_ptr = std::move(service);
+                    return;
+                }
+
+                log_warn(tr::f_("io_uring is not available, thread pool is used for file I/O: {}"
+                    , err));
+            }
+#   endif
+
+            _io_service_ptr = pfs::make_unique<thread_pool_io_service<function_queue_type>>(
+                _io_thread_count);
+        }
+
+        io_service_type * io_service () const noexcept
+        {
+            return _io_service_ptr.get();
+        }
+#endif
+
         /**
          * Acquire periodic timer with callback processed from module's queue,
          * or processed from dispatcher's queue or called directly otherwise.
@@ -618,19 +1927,35 @@ struct modulus
          */
         inline pfs::timer_pool::timer_id start_periodic_timer (
               function_queue_type * callback_queue
-            , std::chrono::milliseconds period
-            , typename timer_pool_type::callback_type && callback)
+            , std::chrono::microseconds period
+            , timer_mode mode
+            , tick_callback_type && callback)
         {
-            if (_timer_pool_ptr) {
-                timer_callback_helper timer_callback;
-                timer_callback.callback_queue = callback_queue;
-                timer_callback.callback = std::move(callback);
-                timer_callback.timerid = _timer_pool_ptr->create(period, period, std::move(timer_callback));
+            if (!_timer_pool_ptr || period.count() <= 0)
+                return pfs::timer_pool::timer_id{0};
 
-                return timer_callback.timerid;
-            }
+            auto st = std::make_shared<periodic_timer_state>();
+            st->d = this;
+            st->callback_queue = callback_queue;
+            st->callback = std::move(callback);
+            st->mode = mode;
+            st->period = period;
+            st->start = std::chrono::steady_clock::now();
+            st->catch_up_limit = _timer_catch_up_limit;
 
-            return pfs::timer_pool::timer_id{0};
+            auto id = _timer_pool_ptr->create(period, period, mode, nullptr
+                , [st] { periodic_timer_state::fire(st); });
+
+            st->id.store(id);
+
+            // Fixed-delay tick processed before the identifier is stored
+            if (st->resume_deferred.exchange(true))
+                resume_timer(id);
+
+            std::unique_lock<std::mutex> locker(_periodic_timers_mtx);
+            _periodic_timers[id] = st;
+
+            return id;
         }
 
         /**
@@ -642,23 +1967,39 @@ struct modulus
          */
         inline pfs::timer_pool::timer_id start_timer (
               function_queue_type * callback_queue
-            , std::chrono::milliseconds timeout
+            , std::chrono::microseconds timeout
             , typename timer_pool_type::callback_type && callback)
         {
             if (_timer_pool_ptr) {
-                timer_callback_helper timer_callback;
-                timer_callback.callback_queue = callback_queue;
-                timer_callback.callback = std::move(callback);
-                timer_callback.timerid = _timer_pool_ptr->create(timeout, std::move(timer_callback));
-
-                return timer_callback.timerid;
+                return _timer_pool_ptr->create(timeout, std::chrono::microseconds{0}
+                    , timer_mode::fixed_rate, callback_queue, std::move(callback));
             }
 
             return pfs::timer_pool::timer_id{0};
         }
 
+        inline void resume_timer (pfs::timer_pool::timer_id id)
+        {
+            if (_timer_pool_ptr)
+                _timer_pool_ptr->resume(id);
+        }
+
         inline void destroy_timer (pfs::timer_pool::timer_id & id)
         {
+            {
+                std::unique_lock<std::mutex> locker(_periodic_timers_mtx);
+                auto pos = _periodic_timers.find(id);
+
+                if (pos != _periodic_timers.end()) {
+                    auto st = pos->second.lock();
+
+                    if (st)
+                        st->cancelled.store(true);
+
+                    _periodic_timers.erase(pos);
+                }
+            }
+
             // _timer_pool_ptr may be already destroyed (i.e. on finalize())
             if (_timer_pool_ptr) {
                 _timer_pool_ptr->destroy(id);
@@ -672,6 +2013,77 @@ struct modulus
             return & _q;
         }
 
+        /**
+         * Wakes up the dispatcher and all runnable modules waiting for events
+         * by pushing an empty action into their queues. Must be called after
+         * any state change (e.g. quit flag) that waiting threads need to
+         * check.
+         */
+        void wakeup_all ()
+        {
+            _q.wakeup();
+
+            for (auto & ctx: _module_specs) {
+                basic_module * m = ctx.second.module();
+
+                if (m->is_runnable())
+                    m->queue()->wakeup();
+            }
+        }
+
+        module_options load_module_options (string_type const & name)
+        {
+            module_options opts;
+
+            opts.queue.capacity = static_cast<std::size_t>(_settings.get(name + ".queue.capacity"
+                , static_cast<std::uint64_t>(opts.queue.capacity)));
+
+            auto overflow = _settings.get(name + ".queue.overflow", std::string{});
+
+            if (overflow == "block")
+                opts.queue.overflow = overflow_policy::block;
+            else if (overflow == "drop_newest")
+                opts.queue.overflow = overflow_policy::drop_newest;
+            else if (overflow == "drop_oldest")
+                opts.queue.overflow = overflow_policy::drop_oldest;
+            else if (overflow == "fail")
+                opts.queue.overflow = overflow_policy::fail;
+            else if (!overflow.empty())
+                log_warn(tr::f_("{}: bad queue overflow policy in settings: {}", name, overflow));
+
+            opts.queue.starvation_limit = static_cast<std::size_t>(_settings.get(name + ".queue.starvation_limit"
+                , static_cast<std::uint64_t>(opts.queue.starvation_limit)));
+
+            opts.queue.weight = static_cast<std::size_t>(_settings.get(name + ".queue.weight"
+                , static_cast<std::uint64_t>(opts.queue.weight)));
+
+            opts.queue.spin_time = std::chrono::microseconds{static_cast<std::chrono::microseconds::rep>(
+                _settings.get(name + ".queue.spin_time", static_cast<std::uint64_t>(0)))};
+
+            opts.queue.yield_time = std::chrono::microseconds{static_cast<std::chrono::microseconds::rep>(
+                _settings.get(name + ".queue.yield_time", static_cast<std::uint64_t>(0)))};
+
+            opts.dedicated_thread = _settings.get(name + ".dedicated_thread", opts.dedicated_thread);
+
+            auto cpu_set = _settings.get(name + ".cpu_set", std::string{});
+
+            if (!cpu_set.empty() && !parse_cpu_list(cpu_set, opts.placement.cpu_set))
+                log_warn(tr::f_("{}: bad CPU list in settings: {}", name, cpu_set));
+
+            opts.placement.numa_node = _settings.get(name + ".numa_node", opts.placement.numa_node);
+            opts.placement.fifo_priority = _settings.get(name + ".fifo_priority", opts.placement.fifo_priority);
+
+            return opts;
+        }
+
+        void apply_module_options (module_context & ctx)
+        {
+            auto module_ptr = ctx.module();
+
+            if (module_ptr->is_runnable() || module_ptr->is_guest())
+                module_ptr->queue()->set_options(ctx.options().queue);
+        }
+
         // Logger backend for direct printing
         void direct_print (void (logger_type::*log)(string_type const &)
             , basic_module const * m
@@ -685,7 +2097,9 @@ struct modulus
             , basic_module const * m
             , string_type const & s)
         {
-            _q.push(log, _logger, (m != 0 ? m->name() + ": " + s : s));
+            // Not limited by capacity: may be called from the dispatcher's
+            // thread (see module_queue::push_unbounded())
+            _q.push_unbounded(log, _logger, (m != 0 ? m->name() + ": " + s : s));
         }
 
         bool register_module_helper (
@@ -734,11 +2148,8 @@ struct modulus
                 return false;
             }
 
-            // Cross-connecting emitters of just registering module and already
-            // registered modules.
-            // If _module_specs is empty so emitters of just registering module
-            // will be connected with own detectors only.
-            ctx.connect_emitters(_module_specs.begin(), _module_specs.end());
+            ctx._options = load_module_options(ctx.name());
+            apply_module_options(ctx);
 
             // Emplace module into module specs container
             {
@@ -748,6 +2159,16 @@ struct modulus
                 assert(emplaced_module.second);
                 auto & ctx = emplaced_module.first->second;
 
+                // Cross-connecting emitters of just registering module and
+                // already registered modules (deferred until commit_batch()
+                // in batch mode).
+                if (_batch_active) {
+                    _pending_wiring.push_back(& ctx);
+                } else {
+                    log_trace(tr::_("Connecting emitters:"));
+                    connect_modules(context_list_type{& ctx}, true);
+                }
+
                 log_debug(tr::f_("{}: registered ({})", ctx.name(), ctx.path()));
 
                 // Notify external subscribers
@@ -757,6 +2178,107 @@ struct modulus
             return true;
         }
 
+        // Connects emitters and detectors of just registered modules with
+        // corresponding detectors and emitters of registered modules (including
+        // own ones and each other) using API identifier index.
+        //
+        // Returns number of connections.
+        std::size_t connect_modules (context_list_type const & pending, bool trace)
+        {
+            std::size_t count = 0;
+
+            // Index all modules first
+            for (auto ctx: pending) {
+                ctx->_wiring_pending = true;
+
+                if (ctx->_any_detector) {
+                    _any_detector_modules.push_back(ctx);
+                } else {
+                    for (auto const & id: ctx->_detector_ids)
+                        _detector_index[id].push_back(ctx);
+                }
+
+                for (auto & em: ctx->_emitter_cache)
+                    _emitter_index[em.first].push_back(ctx);
+            }
+
+            for (auto ctx: pending) {
+                // Detectors of the module with emitters of already wired
+                // modules (emitters of pending modules are processed below)
+                if (ctx->_any_detector) {
+                    for (auto & item: _emitter_index) {
+                        for (auto ectx: item.second) {
+                            if (!ectx->_wiring_pending && ctx->connect_detector_of(*ectx, item.first, trace))
+                                ++count;
+                        }
+                    }
+                } else {
+                    for (auto const & id: ctx->_detector_ids) {
+                        auto pos = _emitter_index.find(id);
+
+                        if (pos != _emitter_index.end()) {
+                            for (auto ectx: pos->second) {
+                                if (!ectx->_wiring_pending && ctx->connect_detector_of(*ectx, id, trace))
+                                    ++count;
+                            }
+                        }
+                    }
+                }
+
+                // Emitters of the module with all detectors
+                for (auto & em: ctx->_emitter_cache) {
+                    auto id = em.first;
+                    auto pos = _detector_index.find(id);
+
+                    if (pos != _detector_index.end()) {
+                        for (auto dctx: pos->second) {
+                            if (dctx->connect_detector_of(*ctx, id, trace))
+                                ++count;
+                        }
+                    }
+
+                    for (auto dctx: _any_detector_modules) {
+                        if (dctx->connect_detector_of(*ctx, id, trace))
+                            ++count;
+                    }
+                }
+            }
+
+            for (auto ctx: pending)
+                ctx->_wiring_pending = false;
+
+            return count;
+        }
+
+        void disconnect_module (module_context & ctx)
+        {
+            ctx.disconnect_emitters();
+
+            auto remove_from = [& ctx] (std::map<api_id_type, context_list_type> & index, api_id_type const & id) {
+                auto pos = index.find(id);
+
+                if (pos != index.end()) {
+                    auto & l = pos->second;
+                    l.erase(std::remove(l.begin(), l.end(), & ctx), l.end());
+
+                    if (l.empty())
+                        index.erase(pos);
+                }
+            };
+
+            for (auto & em: ctx._emitter_cache)
+                remove_from(_emitter_index, em.first);
+
+            for (auto const & id: ctx._detector_ids)
+                remove_from(_detector_index, id);
+
+            _any_detector_modules.erase(std::remove(_any_detector_modules.begin()
+                , _any_detector_modules.end(), & ctx), _any_detector_modules.end());
+
+            _pending_wiring.erase(std::remove(_pending_wiring.begin()
+                , _pending_wiring.end(), & ctx), _pending_wiring.end());
+        }
+
         typename module_context_map_type::iterator
         unregister_module_helper (typename module_context_map_type::iterator pos)
         {
@@ -764,7 +2286,7 @@ struct modulus
             auto is_runnable = module_ptr->runnable();
             auto name = module_ptr->name();
 
-            pos->second.disconnect_emitters();
+            disconnect_module(pos->second);
             auto result = _module_specs.erase(pos);
 
             log_debug(tr::f_("{}: unregistered", name));
@@ -787,8 +2309,38 @@ struct modulus
             return result;
         }
 
-        // Thread function for dispatcher and runnable modules
-        exit_status runnable_main (string_type const & name)
+        // Applies placement options of the dispatcher (if name is empty) or
+        // runnable module to the current thread
+        void apply_placement (string_type const & name)
+        {
+            placement_options const * opts = & _placement;
+
+            if (!name.empty()) {
+                auto runnable_it = _module_specs.find(name);
+
+                if (runnable_it == _module_specs.end())
+                    return;
+
+                opts = & runnable_it->second.options().placement;
+            }
+
+            if (opts->empty())
+                return;
+
+            auto error = apply_thread_placement(*opts);
+
+            if (!error.empty()) {
+                log_warn(tr::f_("{}: thread placement failure: {}"
+                    , name.empty() ? string_type{"dispatcher"} : name, error));
+            } else {
+                log_trace(tr::f_("{}: thread placement applied"
+                    , name.empty() ? string_type{"dispatcher"} : name));
+            }
+        }
+
+        // Starts dispatcher (if name is empty) or runnable module and their
+        // guest modules
+        exit_status start_runnable (string_type const & name)
         {
             auto r = exit_status::success;
 
@@ -851,6 +2403,16 @@ struct modulus
                     unregister_module(modname);
             }
 
+            return r;
+        }
+
+        // Thread function for dispatcher and runnable modules
+        exit_status runnable_main (string_type const & name)
+        {
+            apply_placement(name);
+
+            auto r = start_runnable(name);
+
             // Run
             if (r == exit_status::success) {
                 // Dispatcher
@@ -858,8 +2420,16 @@ struct modulus
                     // Redirect log ouput to queued printer
                     _log_printer = & dispatcher::queued_print;
 
+                    // Woken up by any queued action, including the empty one
+                    // pushed by wakeup_all() on quit
                     while (! _quit_flag) {
-                        _q.wait_for(_wait_period);
+#if MODULUS__REACTOR_ENABLED
+                        if (_reactor)
+                            _reactor->wait(-1, [this] { return ! _q.empty() || _quit_flag; });
+                        else
+#endif
+                        _q.wait();
+
                         _q.call_all();
                     }
 
@@ -867,6 +2437,14 @@ struct modulus
                     _timer_pool_ptr->destroy_all();
                     _timer_pool_ptr.reset();
 
+                    {
+                        std::unique_lock<std::mutex> locker(_periodic_timers_mtx);
+                        _periodic_timers.clear();
+                    }
+
+                    // Nobody waits for free space in the queue from now
+                    _q.set_options(queue_options{});
+
                     // Force call of pending callbacks
                     _q.call_all();
 
@@ -880,15 +2458,32 @@ struct modulus
                     assert(module_ptr);
                     assert(module_ptr->runnable());
 
+                    // Emissions from run() outside of queue calls can be
+                    // direct too (see connection_mode::direct)
+                    module_ptr->queue()->set_owner(std::this_thread::get_id());
+
                     r = module_ptr->runnable()->run();
 
+                    // Nobody waits for free space in the queue from now
+                    module_ptr->queue()->set_options(queue_options{});
+
                     // Force call of pending callbacks
                     module_ptr->runnable()->flush();
+
+                    module_ptr->queue()->set_owner(std::thread::id{});
                 }
             } else {
                 _quit_flag.store(-1);
+                wakeup_all();
             }
 
+            return finish_runnable(name, r);
+        }
+
+        // Finalizes guest modules of the dispatcher (if name is empty) or
+        // runnable module and the runnable module itself
+        exit_status finish_runnable (string_type const & name, exit_status r)
+        {
             // Finalize children
             for (auto & ctx: _module_specs) {
                 if (ctx.second.parent_name() == name) {
@@ -946,6 +2541,208 @@ struct modulus
             _ignore_module_on_start_failure = enable;
         }
 
+        /**
+         * Enables M:N execution mode: runnable modules (except ones that
+         * require dedicated thread, see module_options::dedicated_thread,
+         * modules loaded from dynamic libraries and the "main" thread module)
+         * are processed as serialized tasks
+         * (strands) on the work-stealing pool of @a thread_count threads
+         * (number of hardware threads if zero) instead of own threads.
+         * on_start() and on_finish() of such modules are called from the
+         * exec() caller thread.
+         *
+         * NOTE! Method run() of such modules is never called. exec() fails if
+         * any of such modules overrides run(), has poll loop enabled, watches
+         * file descriptors or has queue with
+         * overflow_policy::block policy: producer blocked on the full queue
+         * occupies the pool thread, so blocked producers can occupy all
+         * threads while the full queues are consumed by the pool only.
+         *
+         * Must be called before exec().
+         */
+        void enable_worker_pool (std::size_t thread_count = 0)
+        {
+            _worker_pool_enabled = true;
+            _worker_pool_size = thread_count;
+        }
+
+        /**
+         * Sets options for the registered module overriding ones loaded from
+         * settings.
+         *
+         * @return @c false if module not found.
+         */
+        bool set_module_options (string_type const & name, module_options const & opts)
+        {
+            auto ctx_it = _module_specs.find(name);
+
+            if (ctx_it == _module_specs.end())
+                return false;
+
+            ctx_it->second._options = opts;
+            apply_module_options(ctx_it->second);
+            return true;
+        }
+
+        /**
+         * Sets placement of the dispatcher thread. Must be called before
+         * exec().
+         */
+        void set_thread_placement (placement_options const & opts)
+        {
+            _placement = opts;
+        }
+
+        /**
+         * Selects timer implementation. Must be called before exec().
+         *
+         * @param resolution Tick duration for timer_backend::timing_wheel
+         *        (timer_backend::timer_pool has millisecond resolution).
+         */
+        void set_timer_backend (timer_backend backend
+            , std::chrono::microseconds resolution = std::chrono::milliseconds{1})
+        {
+            _timer_backend = backend;
+            _timer_resolution = resolution;
+        }
+
+#if MODULUS__IO_SERVICE_ENABLED
+        /**
+         * Enables asynchronous file I/O service for modules (see
+         * basic_module::async_read(), basic_module::async_write() and
+         * basic_module::async_fsync()). If io_uring is not available (e.g.
+         * old kernel or seccomp policy) io_backend::thread_pool is used.
+         *
+         * Must be called before exec().
+         *
+         * @param thread_count Number of threads for io_backend::thread_pool.
+         *        Operations are executed in submission order only if it is 1.
+         */
+        void enable_io_service (io_backend backend = io_backend::io_uring
+            , std::size_t thread_count = 1)
+        {
+            _io_service_enabled = true;
+            _io_backend = backend;
+            _io_thread_count = thread_count;
+        }
+#endif
+
+        /**
+         * Sets maximum number of overdue ticks of timer_mode::fixed_rate
+         * periodic timer called in burst after the callback overran the
+         * period (default is 8). Overdue ticks exceeding the limit are skipped
+         * and reported to the next call as missed, zero limit coalesces all
+         * overdue ticks into one call. Applied to timers started after the
+         * call.
+         */
+        void set_timer_catch_up_limit (std::size_t limit)
+        {
+            _timer_catch_up_limit = limit;
+        }
+
+        /**
+         * Sets options for the dispatcher's own queue. Capacity and overflow
+         * policy apply to actions pushed by other threads for regular modules
+         * (e.g. RPC callbacks, periodic timer ticks, I/O completions): they
+         * are blocked, dropped or rejected according to the policy. Log
+         * records and single shot timer callbacks are never dropped and never
+         * block (see module_queue::push_unbounded()), so regular module can
+         * log and arm timers while the queue is full.
+         */
+        void set_queue_options (queue_options const & opts)
+        {
+            _q.set_options(opts);
+        }
+
+#if MODULUS__REACTOR_ENABLED
+        /**
+         * Watches file descriptor @a fd for @a events (combination of
+         * io_event flags). The dispatcher waits for queued actions and events
+         * of watched descriptors in single epoll_wait() call, so @a callback
+         * is called in the dispatcher's thread (as regular modules' code).
+         * Must be called in the dispatcher's thread (e.g. from regular
+         * module's on_start()).
+         *
+         * @return @c false on failure (error is logged).
+         */
+        bool watch_fd (int fd, unsigned events, reactor::callback_type && callback)
+        {
+            if (! _reactor) {
+                auto r = pfs::make_unique<reactor>();
+                auto error = r->open();
+
+                if (! error.empty()) {
+                    log_error(tr::f_("create reactor: {}", error));
+                    return false;
+                }
+
+                _reactor = std::move(r);
+                _q.set_notifier([r = & *_reactor] { r->notify(); });
+            }
+
+            auto error = _reactor->watch(fd, events, std::move(callback));
+
+            if (! error.empty()) {
+                log_error(tr::f_("watch file descriptor {}: {}", fd, error));
+                return false;
+            }
+
+            return true;
+        }
+
+        /**
+         * Changes events watched for @a fd.
+         */
+        bool modify_fd (int fd, unsigned events)
+        {
+            auto error = _reactor ? _reactor->modify(fd, events) : string_type{"not watched"};
+
+            if (! error.empty()) {
+                log_error(tr::f_("modify file descriptor {}: {}", fd, error));
+                return false;
+            }
+
+            return true;
+        }
+
+        /**
+         * Stops watching @a fd. Must be called before @a fd is closed.
+         */
+        bool unwatch_fd (int fd)
+        {
+            auto error = _reactor ? _reactor->unwatch(fd) : string_type{"not watched"};
+
+            if (! error.empty()) {
+                log_error(tr::f_("unwatch file descriptor {}: {}", fd, error));
+                return false;
+            }
+
+            return true;
+        }
+#endif
+
+        /**
+         * Returns queue of the module specified by @a name (own queue for
+         * runnable module, subqueue of the parent's queue for guest module,
+         * so its statistics are per guest) or dispatcher's
+         * queue if @a name is empty. Can be used to query queue statistics
+         * (e.g. high-water mark).
+         *
+         * @return @c nullptr if module not found or it is a regular module.
+         */
+        function_queue_type const * queue_for (string_type const & name) const
+        {
+            if (name.empty())
+                return & _q;
+
+            auto ctx_it = _module_specs.find(name);
+
+            if (ctx_it == _module_specs.end())
+                return nullptr;
+
+            return ctx_it->second._module_ptr->queue();
+        }
+
         /**
          * Quit with status.
          *
@@ -961,6 +2758,7 @@ struct modulus
             }
 
             _quit_flag.store(status == 0 ? -1 : status);
+            wakeup_all();
         }
 
         bool is_quit (int & status) const
@@ -1082,12 +2880,43 @@ struct modulus
         template <typename ModuleClass, typename ...Args>
         bool register_module (module_name_type const & name, Args &&... args)
         {
+            std::unique_ptr<ModuleClass, module_deleter> m {
+                  new ModuleClass(std::forward<Args>(args)...)
+                , module_deleter{}};
+
+            detect_run_override<ModuleClass>(& *m);
+
             return register_module_helper(name.first
                 , name.second
                 , std::string{}
-                , std::unique_ptr<ModuleClass, module_deleter>(
-                      new ModuleClass(std::forward<Args>(args)...)
-                    , module_deleter{}));
+                , std::move(m));
+        }
+
+        /**
+         * Registers @a count replicas of in-source defined module named
+         * `<name>.<index>` (e.g. for CPU-heavy processing by several runnable
+         * modules). Emissions are distributed between replicas by detectors
+         * connected with module_context::connect_sharded_detector().
+         *
+         * @return @c false if any replica registration failed, replicas
+         *         registered before remain registered.
+         */
+        template <typename ModuleClass, typename ...Args>
+        bool register_replicas (module_name_type const & name, std::size_t count
+            , Args const &... args)
+        {
+            for (std::size_t i = 0; i < count; i++) {
+                module_pointer m {new ModuleClass(args...), module_deleter{}};
+                m->set_replica(name.first, i, count);
+                detect_run_override<ModuleClass>(& *m);
+
+                if (!register_module_helper(name.first + "." + std::to_string(i)
+                        , name.second, std::string{}, std::move(m))) {
+                    return false;
+                }
+            }
+
+            return true;
         }
 
         /**
@@ -1096,6 +2925,8 @@ struct modulus
         template <typename ModuleClass>
         bool register_static_module (module_name_type const & name, ModuleClass * m)
         {
+            detect_run_override<ModuleClass>(m);
+
             return register_module_helper(name.first
                 , name.second
                 , std::string{}
@@ -1159,6 +2990,41 @@ struct modulus
             return found && success;
         }
 
+        /**
+         * Starts batch registration: modules registered until commit_batch()
+         * (or exec()) call are not wired with each other and with already
+         * registered modules, so emitters of these modules must not be
+         * used before commit.
+         */
+        void begin_batch ()
+        {
+            _batch_active = true;
+        }
+
+        /**
+         * Wires modules registered since begin_batch() in one pass.
+         *
+         * @return Number of connected emitter/detector pairs.
+         */
+        std::size_t commit_batch ()
+        {
+            _batch_active = false;
+
+            if (_pending_wiring.empty())
+                return 0;
+
+            auto start = std::chrono::steady_clock::now();
+            auto count = connect_modules(_pending_wiring, false);
+            auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start);
+
+            log_debug(tr::f_("Batch of {} modules wired: {} connections in {} us"
+                , _pending_wiring.size(), count, elapsed.count()));
+
+            _pending_wiring.clear();
+            return count;
+        }
+
         /**
          * Unregister module with children (if have last)
          *
@@ -1185,6 +3051,74 @@ struct modulus
             }
 
             _module_specs.clear();
+            _pending_wiring.clear();
+            _emitter_index.clear();
+            _detector_index.clear();
+            _any_detector_modules.clear();
+        }
+
+        // Checks if module will be executed on worker pool (if it is enabled)
+        bool runs_on_worker_pool (module_context & ctx) const
+        {
+            auto module_ptr = ctx.module();
+            auto runnable_ptr = dynamic_cast<runnable_module *>(module_ptr);
+
+            return runnable_ptr != nullptr
+                && runnable_ptr->_run_override != runnable_module::run_override::unknown
+                && _main_thread_module != module_ptr->name()
+                && !ctx.options().dedicated_thread;
+        }
+
+        // Inaccessible run() is the override too
+        template <typename ModuleClass>
+        static auto overrides_run (int) -> decltype(& ModuleClass::run, bool{})
+        {
+            return !std::is_same<decltype(& ModuleClass::run)
+                , exit_status (runnable_module::*) ()>::value;
+        }
+
+        template <typename ModuleClass>
+        static bool overrides_run (...)
+        {
+            return true;
+        }
+
+        template <typename ModuleClass>
+        static void detect_run_override (basic_module * m)
+        {
+            auto runnable_ptr = dynamic_cast<runnable_module *>(m);
+
+            if (runnable_ptr != nullptr) {
+                runnable_ptr->_run_override = overrides_run<ModuleClass>(0)
+                    ? runnable_module::run_override::yes
+                    : runnable_module::run_override::no;
+            }
+        }
+
+        // Returns reason the module can't be executed on worker pool or empty
+        // string
+        string_type check_pooled_runnable (module_context & ctx) const
+        {
+            auto module_ptr = ctx.module();
+            auto opts = module_ptr->queue()->options();
+
+            if (opts.capacity > 0 && opts.overflow == overflow_policy::block)
+                return tr::_("producers blocked by overflow policy may deadlock the pool");
+
+            auto runnable_ptr = dynamic_cast<runnable_module *>(module_ptr);
+
+            if (runnable_ptr != nullptr && runnable_ptr->_run_override == runnable_module::run_override::yes)
+                return tr::_("run() is overridden and would never be called");
+
+            if (runnable_ptr != nullptr && runnable_ptr->_poll_interval.count() > 0)
+                return tr::_("poll loop is enabled");
+
+#if MODULUS__REACTOR_ENABLED
+            if (runnable_ptr != nullptr && runnable_ptr->_reactor)
+                return tr::_("file descriptors are watched");
+#endif
+
+            return string_type{};
         }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1214,8 +3148,22 @@ struct modulus
 
         exit_status exec ()
         {
+            // Wire modules registered in not committed batch
+            if (_batch_active)
+                commit_batch();
+
             // Initialize timer pool
-            _timer_pool_ptr = pfs::make_unique<timer_pool_type>();
+            if (_timer_backend == timer_backend::timing_wheel) {
+                _timer_pool_ptr = pfs::make_unique<timing_wheel_backend<function_queue_type>>(
+                    _timer_resolution);
+            } else {
+                _timer_pool_ptr = pfs::make_unique<timer_pool_backend<function_queue_type>>();
+            }
+
+#if MODULUS__IO_SERVICE_ENABLED
+            if (_io_service_enabled)
+                open_io_service();
+#endif
 
             auto r = exit_status::success;
             thread_pool_type thread_pool;
@@ -1229,6 +3177,26 @@ struct modulus
                 }
             }
 
+            // Check modules to be executed on worker pool before any thread
+            // is started
+            if (_worker_pool_enabled) {
+                for (auto & ctx: _module_specs) {
+                    if (!runs_on_worker_pool(ctx.second))
+                        continue;
+
+                    auto error = check_pooled_runnable(ctx.second);
+
+                    if (!error.empty()) {
+                        log_error(tr::f_("module [{}] can't be run on worker pool: {}"
+                            " (run it in dedicated thread)", ctx.second.module()->name(), error));
+                        r = exit_status::failure;
+                    }
+                }
+
+                if (r != exit_status::success)
+                    return r;
+            }
+
             // If has module to be run in "main" thread, run dispatcher in
             // self thread
             if (!_main_thread_module.empty()) {
@@ -1237,6 +3205,44 @@ struct modulus
 
             std::vector<std::string> on_start_failure_modules;
 
+            // Attach strands (suspended until module started) before any
+            // module is started, so producers never see the queue notifier
+            // changed
+            if (_worker_pool_enabled) {
+                _worker_pool_ptr = pfs::make_unique<worker_pool>(_worker_pool_size);
+
+                for (auto & ctx: _module_specs) {
+                    auto module_ptr = ctx.second.module();
+
+                    if (runs_on_worker_pool(ctx.second)) {
+                        if (!ctx.second.options().placement.empty()) {
+                            log_warn(tr::f_("{}: thread placement ignored for module"
+                                " run on worker pool", module_ptr->name()));
+                        }
+
+                        static_cast<runnable_module *>(module_ptr)->_pooled = true;
+
+                        auto strand_ptr = pfs::make_unique<strand_type>(*_worker_pool_ptr, *module_ptr->queue());
+                        auto sp = & *strand_ptr;
+                        module_ptr->queue()->set_notifier([sp] { sp->notify(); });
+                        _pooled_runnables.push_back(pooled_runnable{module_ptr->name()
+                            , exit_status::success, std::move(strand_ptr)});
+                    }
+                }
+
+                log_trace(tr::f_("worker pool started with {} threads for {} runnable modules"
+                    , _worker_pool_ptr->size(), _pooled_runnables.size()));
+            }
+
+            auto is_pooled = [this] (string_type const & name) {
+                for (auto const & x: _pooled_runnables) {
+                    if (x.name == name)
+                        return true;
+                }
+
+                return false;
+            };
+
             for (auto & ctx: _module_specs) {
                 auto module_ptr = ctx.second.module();
 
@@ -1247,6 +3253,11 @@ struct modulus
                         log_trace(tr::f_("module [{}] will be run in \"main\" thread"
                             , module_ptr->name()));
 
+                        // Launching is below
+                    } else if (is_pooled(module_ptr->name())) {
+                        log_trace(tr::f_("module [{}] will be run on worker pool"
+                            , module_ptr->name()));
+
                         // Launching is below
                     } else {
                         thread_pool.emplace_back(& dispatcher::runnable_main, this, module_ptr->name());
@@ -1275,6 +3286,18 @@ struct modulus
             for (auto const & modname: on_start_failure_modules)
                 unregister_module(modname);
 
+            // Start modules executed on worker pool
+            for (auto & x: _pooled_runnables) {
+                x.status = start_runnable(x.name);
+
+                if (x.status == exit_status::success) {
+                    x.strand_ptr->start();
+                } else {
+                    _quit_flag.store(-1);
+                    wakeup_all();
+                }
+            }
+
             // Launch dispatcher or "main" module (according to _main_thread_module value)
             if (r == exit_status::success) {
                 std::string exception_string;
@@ -1300,6 +3323,27 @@ struct modulus
                     th.join();
             }
 
+            // Finalize modules executed on worker pool
+            if (_worker_pool_ptr) {
+                _worker_pool_ptr->stop();
+
+                for (auto & x: _pooled_runnables) {
+                    auto runnable_it = _module_specs.find(x.name);
+
+                    if (runnable_it == _module_specs.end())
+                        continue;
+
+                    auto module_ptr = runnable_it->second.module();
+
+                    if (x.status == exit_status::success) {
+                        module_ptr->queue()->set_options(queue_options{});
+                        module_ptr->runnable()->flush();
+                    }
+
+                    finish_runnable(x.name, x.status);
+                }
+            }
+
             // Finalize regular modules
             for (auto & ctx: _module_specs) {
                 auto module_ptr = ctx.second.module();
@@ -1310,8 +3354,22 @@ struct modulus
                 }
             }
 
+#if MODULUS__IO_SERVICE_ENABLED
+            // Wait for submitted operations before modules (owners of the
+            // buffers and callback queues) are destroyed
+            if (_io_service_ptr) {
+                _io_service_ptr->stop();
+                _io_service_ptr.reset();
+            }
+#endif
+
             unregister_all();
 
+            // Strands are referenced by queues of modules, so destroy them
+            // after modules unregistered
+            _pooled_runnables.clear();
+            _worker_pool_ptr.reset();
+
             return r;
         }
     }; // dispatcher
@@ -1332,30 +3390,57 @@ struct modulus
 
     public:
         /**
-         * Start periodic timer.
+         * Start periodic timer. Period is rounded up to the timer resolution
+         * (1 ms by default, see dispatcher::set_timer_backend()).
          */
+        template <typename Rep, typename Period>
         inline pfs::timer_pool::timer_id start_periodic_timer (
-              std::chrono::milliseconds period
-            , typename dispatcher::timer_pool_type::callback_type && callback)
+              std::chrono::duration<Rep, Period> period
+            , typename dispatcher::timer_pool_type::callback_type && callback
+            , timer_mode mode = timer_mode::fixed_rate)
+        {
+            // Run callback in dispatcher's queue.
+            return this->_dispatcher_ptr->start_periodic_timer(
+                  this->_dispatcher_ptr->queue()
+                , ceil_microseconds(period)
+                , mode
+                , [cb = std::move(callback)] (std::size_t) { cb(); });
+        }
+
+        /**
+         * Start periodic timer with callback that receives number of missed
+         * ticks (e.g. when previous call overran the period). Overdue ticks of
+         * timer_mode::fixed_rate timer are called in burst up to the catch-up
+         * limit (see dispatcher::set_timer_catch_up_limit()). Period is
+         * rounded up to the timer resolution as above.
+         */
+        template <typename Rep, typename Period>
+        inline pfs::timer_pool::timer_id start_periodic_timer (
+              std::chrono::duration<Rep, Period> period
+            , tick_callback_type && callback
+            , timer_mode mode = timer_mode::fixed_rate)
         {
             // Run callback in dispatcher's queue.
             return this->_dispatcher_ptr->start_periodic_timer(
                   this->_dispatcher_ptr->queue()
-                , period
+                , ceil_microseconds(period)
+                , mode
                 , std::move(callback));
         }
 
         /**
-         * Start single shot timer.
+         * Start single shot timer. Timeout is rounded up to the timer
+         * resolution (1 ms by default, see dispatcher::set_timer_backend()).
          */
+        template <typename Rep, typename Period>
         inline pfs::timer_pool::timer_id start_timer (
-              std::chrono::milliseconds timeout
+              std::chrono::duration<Rep, Period> timeout
             , typename dispatcher::timer_pool_type::callback_type && callback)
         {
             // Run callback in dispatcher's queue.
             return this->_dispatcher_ptr->start_timer(
                   this->_dispatcher_ptr->queue()
-                , timeout
+                , ceil_microseconds(timeout)
                 , std::move(callback));
         }
 
@@ -1363,6 +3448,27 @@ struct modulus
         {
             this->_dispatcher_ptr->destroy_timer(id);
         }
+
+#if MODULUS__REACTOR_ENABLED
+        /**
+         * Watches file descriptor @a fd in the dispatcher's thread (see
+         * dispatcher::watch_fd()).
+         */
+        bool watch_fd (int fd, unsigned events, reactor::callback_type && callback)
+        {
+            return this->_dispatcher_ptr->watch_fd(fd, events, std::move(callback));
+        }
+
+        bool modify_fd (int fd, unsigned events)
+        {
+            return this->_dispatcher_ptr->modify_fd(fd, events);
+        }
+
+        bool unwatch_fd (int fd)
+        {
+            return this->_dispatcher_ptr->unwatch_fd(fd);
+        }
+#endif
     };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1374,9 +3480,109 @@ struct modulus
         friend class dispatcher;
         friend class module_context;
 
+#if MODULUS__REACTOR_ENABLED
+    private:
+        // Created by the first watch_fd() call. Outlives the queue, which
+        // notifies it.
+        std::unique_ptr<reactor> _reactor;
+#endif
+
     protected:
         mutable function_queue_type _q;
 
+    private:
+        // Poll loop of the default run() (see set_poll_interval())
+        std::chrono::microseconds _poll_interval {0};
+        std::chrono::microseconds _drain_budget {0};
+        std::atomic<std::size_t> _poll_count {0};
+        std::atomic<std::size_t> _budget_exhausted_count {0};
+        std::atomic<std::chrono::microseconds::rep> _max_poll_delay {0};
+
+        // Executed on worker pool (set by dispatcher before on_start())
+        bool _pooled {false};
+
+        // Whether module class overrides run() (set by dispatcher on
+        // registration of in-source defined module)
+        enum class run_override { unknown, no, yes };
+        run_override _run_override {run_override::unknown};
+
+    private:
+        bool has_reactor () const noexcept
+        {
+#if MODULUS__REACTOR_ENABLED
+            return _reactor != nullptr;
+#else
+            return false;
+#endif
+        }
+
+        // Waits for queued actions (and watched file descriptors events)
+        // until @a limit
+        void wait_events (deadline_clock::time_point limit)
+        {
+#if MODULUS__REACTOR_ENABLED
+            if (_reactor) {
+                int timeout_ms = -1;
+
+                if (limit != deadline_clock::time_point::max()) {
+                    auto rest = ceil_microseconds(limit - deadline_clock::now()).count();
+                    timeout_ms = rest > 0 ? static_cast<int>((rest + 999) / 1000) : 0;
+                }
+
+                _reactor->wait(timeout_ms, [this] { return ! _q.empty() || this->is_quit(); });
+                return;
+            }
+#endif
+            auto now = deadline_clock::now();
+
+            if (limit > now)
+                _q.wait_for(ceil_microseconds(limit - now).count());
+        }
+
+        // Loop of the default run() with poll hook and/or reactor
+        exit_status event_loop ()
+        {
+            auto poll_enabled = _poll_interval.count() > 0;
+            auto next_poll = poll_enabled ? deadline_clock::now() : deadline_clock::time_point::max();
+
+            while (! this->is_quit()) {
+                auto now = deadline_clock::now();
+
+                if (now >= next_poll) {
+                    auto delay = std::chrono::duration_cast<std::chrono::microseconds>(now - next_poll);
+
+                    if (delay.count() > _max_poll_delay.load(std::memory_order_relaxed))
+                        _max_poll_delay.store(delay.count(), std::memory_order_relaxed);
+
+                    on_poll();
+                    ++_poll_count;
+
+                    // Missed polls are skipped, not called in burst
+                    next_poll += _poll_interval;
+
+                    if (next_poll < now)
+                        next_poll = now + _poll_interval;
+                }
+
+                if (poll_enabled)
+                    this->call_for(_drain_budget);
+                else
+                    this->call_all();
+
+                // Continue draining after the next poll (if it is due)
+                if (! _q.empty()) {
+                    if (poll_enabled)
+                        ++_budget_exhausted_count;
+
+                    continue;
+                }
+
+                wait_events(next_poll);
+            }
+
+            return exit_status::success;
+        }
+
     protected:
         function_queue_type * queue () const override
         {
@@ -1398,6 +3604,16 @@ struct modulus
             return _q.call_all();
         }
 
+        /**
+         * Calls queued actions until the queue is empty or time @a budget is
+         * exhausted (see module_queue::call_for()).
+         */
+        template <typename Rep, typename Period>
+        std::size_t call_for (std::chrono::duration<Rep, Period> budget)
+        {
+            return _q.call_for(ceil_microseconds(budget).count());
+        }
+
         void wait ()
         {
             _q.wait();
@@ -1408,15 +3624,130 @@ struct modulus
             return _q.wait_for(microseconds.count());
         }
 
+        /**
+         * Enables poll loop of the default run(): on_poll() is called every
+         * @a interval, queued actions are called between polls for at most
+         * @a drain_budget at once, so the poll period is kept under bursty
+         * input. Zero interval disables the poll loop. Must be called before
+         * the module is started. Module with the poll loop must be run in
+         * dedicated thread (see module_options::dedicated_thread): exec() fails
+         * otherwise, call from on_start() of the module executed on worker
+         * pool is ignored (error is logged).
+         */
+        template <typename Rep1, typename Period1, typename Rep2, typename Period2>
+        void set_poll_interval (std::chrono::duration<Rep1, Period1> interval
+            , std::chrono::duration<Rep2, Period2> drain_budget)
+        {
+            if (_pooled) {
+                this->log_error(tr::_("poll loop is not available for module run on worker pool"));
+                return;
+            }
+
+            _poll_interval = ceil_microseconds(interval);
+            _drain_budget = ceil_microseconds(drain_budget);
+        }
+
+        /**
+         * Poll hook (e.g. for polling the hardware) called by the default
+         * run() if poll loop is enabled (see set_poll_interval()).
+         */
+        virtual void on_poll () {}
+
+#if MODULUS__REACTOR_ENABLED
+        /**
+         * Watches file descriptor @a fd for @a events (combination of
+         * io_event flags). The default run() waits for queued actions and
+         * events of watched descriptors in single epoll_wait() call, so
+         * @a callback is called in the module's thread. Must be called in the
+         * module's thread (e.g. from on_start() or queued action). Module
+         * watching file descriptors must be run in dedicated thread (see
+         * module_options::dedicated_thread), queue wait strategy is not
+         * applied to it.
+         *
+         * @return @c false on failure or if module is run on worker pool
+         *         (error is logged).
+         */
+        bool watch_fd (int fd, unsigned events, reactor::callback_type && callback)
+        {
+            // Worker pool thread does not wait for descriptors
+            if (_pooled) {
+                this->log_error(tr::_("file descriptor watching is not available"
+                    " for module run on worker pool"));
+                return false;
+            }
+
+            if (! _reactor) {
+                auto r = pfs::make_unique<reactor>();
+                auto error = r->open();
+
+                if (! error.empty()) {
+                    this->log_error(tr::f_("create reactor: {}", error));
+                    return false;
+                }
+
+                _reactor = std::move(r);
+                _q.set_notifier([r = & *_reactor] { r->notify(); });
+            }
+
+            auto error = _reactor->watch(fd, events, std::move(callback));
+
+            if (! error.empty()) {
+                this->log_error(tr::f_("watch file descriptor {}: {}", fd, error));
+                return false;
+            }
+
+            return true;
+        }
+
+        /**
+         * Changes events watched for @a fd.
+         */
+        bool modify_fd (int fd, unsigned events)
+        {
+            auto error = _reactor ? _reactor->modify(fd, events) : string_type{"not watched"};
+
+            if (! error.empty()) {
+                this->log_error(tr::f_("modify file descriptor {}: {}", fd, error));
+                return false;
+            }
+
+            return true;
+        }
+
+        /**
+         * Stops watching @a fd. Must be called before @a fd is closed.
+         */
+        bool unwatch_fd (int fd)
+        {
+            auto error = _reactor ? _reactor->unwatch(fd) : string_type{"not watched"};
+
+            if (! error.empty()) {
+                this->log_error(tr::f_("unwatch file descriptor {}: {}", fd, error));
+                return false;
+            }
+
+            return true;
+        }
+#endif
+
+        /**
+         * Default loop: calls queued actions until quit (with poll hook
+         * and/or file descriptor watching if enabled).
+         *
+         * NOTE! Not called for module executed on worker pool, module class
+         * overriding it is rejected by dispatcher::exec() unless it is run in
+         * dedicated thread (see module_options::dedicated_thread).
+         */
         exit_status run () override
         {
+            // Dispatcher wakes up the queue on quit (see dispatcher::wakeup_all())
             while (! this->is_quit()) {
-                if (_q.empty()) {
-                    if (_q.wait_for(500000))
-                        this->call_all();
-                } else {
-                    this->call_all();
-                }
+                // Reactor can be created by queued action (see watch_fd())
+                if (_poll_interval.count() > 0 || has_reactor())
+                    return event_loop();
+
+                _q.wait();
+                this->call_all();
             }
 
             return exit_status::success;
@@ -1433,27 +3764,82 @@ struct modulus
             _q.call_all();
         }
 
+        /**
+         * Number of on_poll() calls.
+         */
+        std::size_t poll_count () const noexcept
+        {
+            return _poll_count.load();
+        }
+
+        /**
+         * Number of poll loop iterations that left pending actions because
+         * the drain budget was exhausted.
+         */
+        std::size_t budget_exhausted_count () const noexcept
+        {
+            return _budget_exhausted_count.load();
+        }
+
+        /**
+         * Maximum delay of on_poll() call relative to its schedule.
+         */
+        std::chrono::microseconds max_poll_delay () const noexcept
+        {
+            return std::chrono::microseconds{_max_poll_delay.load()};
+        }
+
     public:
         /**
-         * Start periodic timer.
+         * Start periodic timer. Period is rounded up to the timer resolution
+         * (1 ms by default, see dispatcher::set_timer_backend()).
          */
+        template <typename Rep, typename Period>
         inline pfs::timer_pool::timer_id start_periodic_timer (
-              std::chrono::milliseconds period
-            , typename dispatcher::timer_pool_type::callback_type && callback)
+              std::chrono::duration<Rep, Period> period
+            , typename dispatcher::timer_pool_type::callback_type && callback
+            , timer_mode mode = timer_mode::fixed_rate)
         {
             return this->_dispatcher_ptr->start_periodic_timer(
-                this->queue(), period, std::move(callback));
+                  this->queue()
+                , ceil_microseconds(period)
+                , mode
+                , [cb = std::move(callback)] (std::size_t) { cb(); });
+        }
+
+        /**
+         * Start periodic timer with callback that receives number of missed
+         * ticks (e.g. when previous call overran the period). Overdue ticks of
+         * timer_mode::fixed_rate timer are called in burst up to the catch-up
+         * limit (see dispatcher::set_timer_catch_up_limit()). Period is
+         * rounded up to the timer resolution as above.
+         */
+        template <typename Rep, typename Period>
+        inline pfs::timer_pool::timer_id start_periodic_timer (
+              std::chrono::duration<Rep, Period> period
+            , tick_callback_type && callback
+            , timer_mode mode = timer_mode::fixed_rate)
+        {
+            return this->_dispatcher_ptr->start_periodic_timer(
+                  this->queue()
+                , ceil_microseconds(period)
+                , mode
+                , std::move(callback));
         }
 
         /**
-         * Start single shot timer.
+         * Start single shot timer. Timeout is rounded up to the timer
+         * resolution (1 ms by default, see dispatcher::set_timer_backend()).
          */
+        template <typename Rep, typename Period>
         inline pfs::timer_pool::timer_id start_timer (
-              std::chrono::milliseconds timeout
+              std::chrono::duration<Rep, Period> timeout
             , typename dispatcher::timer_pool_type::callback_type && callback)
         {
-            return this->_dispatcher_ptr->start_timer(this->queue()
-                , timeout, std::move(callback));
+            return this->_dispatcher_ptr->start_timer(
+                  this->queue()
+                , ceil_microseconds(timeout)
+                , std::move(callback));
         }
 
         inline void destroy_timer (pfs::timer_pool::timer_id & id)
@@ -1472,6 +3858,10 @@ struct modulus
 
         function_queue_type * _parent_queue {nullptr};
 
+        // Subqueue of the parent's queue, so busy guest module does not
+        // starve other guests of the same parent
+        mutable function_queue_type _q;
+
     protected:
         bool is_guest () const noexcept override
         {
@@ -1480,35 +3870,66 @@ struct modulus
 
         function_queue_type * queue () const override
         {
-            return _parent_queue;
+            return & _q;
         }
 
         void set_parent_queue (function_queue_type * q)
         {
             _parent_queue = q;
+            _parent_queue->attach_subqueue(_q);
         }
 
     public:
         /**
-         * Start periodic timer.
+         * Start periodic timer. Period is rounded up to the timer resolution
+         * (1 ms by default, see dispatcher::set_timer_backend()).
          */
+        template <typename Rep, typename Period>
         inline pfs::timer_pool::timer_id start_periodic_timer (
-              std::chrono::milliseconds period
-            , typename dispatcher::timer_pool_type::callback_type && callback)
+              std::chrono::duration<Rep, Period> period
+            , typename dispatcher::timer_pool_type::callback_type && callback
+            , timer_mode mode = timer_mode::fixed_rate)
+        {
+            return this->_dispatcher_ptr->start_periodic_timer(
+                  this->queue()
+                , ceil_microseconds(period)
+                , mode
+                , [cb = std::move(callback)] (std::size_t) { cb(); });
+        }
+
+        /**
+         * Start periodic timer with callback that receives number of missed
+         * ticks (e.g. when previous call overran the period). Overdue ticks of
+         * timer_mode::fixed_rate timer are called in burst up to the catch-up
+         * limit (see dispatcher::set_timer_catch_up_limit()). Period is
+         * rounded up to the timer resolution as above.
+         */
+        template <typename Rep, typename Period>
+        inline pfs::timer_pool::timer_id start_periodic_timer (
+              std::chrono::duration<Rep, Period> period
+            , tick_callback_type && callback
+            , timer_mode mode = timer_mode::fixed_rate)
         {
             return this->_dispatcher_ptr->start_periodic_timer(
-                this->queue(), period, std::move(callback));
+                  this->queue()
+                , ceil_microseconds(period)
+                , mode
+                , std::move(callback));
         }
 
         /**
-         * Start single shot timer.
+         * Start single shot timer. Timeout is rounded up to the timer
+         * resolution (1 ms by default, see dispatcher::set_timer_backend()).
          */
+        template <typename Rep, typename Period>
         inline pfs::timer_pool::timer_id start_timer (
-              std::chrono::milliseconds timeout
+              std::chrono::duration<Rep, Period> timeout
             , typename dispatcher::timer_pool_type::callback_type && callback)
         {
-            return this->_dispatcher_ptr->start_timer(this->queue()
-                , timeout, std::move(callback));
+            return this->_dispatcher_ptr->start_timer(
+                  this->queue()
+                , ceil_microseconds(timeout)
+                , std::move(callback));
         }
 
         inline void destroy_timer (pfs::timer_pool::timer_id & id)
@@ -0,0 +1,239 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Vladislav Trifochkin
+//
+// License: see LICENSE file
+//
+// This file is part of `modulus2-lib`.
+//
+// Changelog:
+//      2026.10.17 Initial version.
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "namespace.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <utility>
+
+MODULUS__NAMESPACE_BEGIN
+
+/**
+ * Lock-free multi-producer/single-consumer function queue (intrusive
+ * Vyukov's queue).
+ *
+ * Producers never take a lock unless the consumer is parked in wait() or
+ * wait_for(). Interface is compatible with pfs::function_queue<>, so the queue
+ * can be used as FunctionQueueType parameter of the modulus template.
+ *
+ * NOTE! Methods call(), call_all(), empty(), wait() and wait_for() must be
+ * called from the consumer thread only.
+ */
+class mpsc_function_queue
+{
+    struct node
+    {
+        std::atomic<node *> next {nullptr};
+
+        virtual ~node () {}
+        virtual void invoke () {}
+    };
+
+    template <typename F>
+    struct function_node: node
+    {
+        F f;
+
+        function_node (F && fn): f(std::move(fn)) {}
+
+        void invoke () override
+        {
+            f();
+        }
+    };
+
+private:
+    // Padding separates producers' and consumer's data to avoid false sharing
+    // (alignas() is not suitable since queue may be allocated dynamically
+    // as a module member and C++14 does not support over-aligned new).
+    std::atomic<node *> _head; // Producers side
+    char _padding[64];
+    node * _tail;              // Consumer side
+    node _stub;
+
+    std::atomic_bool _parked {false};
+    std::mutex _mtx;
+    std::condition_variable _cond;
+
+private:
+    void push_node (node * n)
+    {
+        n->next.store(nullptr, std::memory_order_relaxed);
+        auto prev = _head.exchange(n, std::memory_order_seq_cst);
+        prev->next.store(n, std::memory_order_release);
+    }
+
+    void notify ()
+    {
+        if (_parked.load(std::memory_order_seq_cst)) {
+            std::unique_lock<std::mutex> locker(_mtx);
+            _cond.notify_one();
+        }
+    }
+
+    // Returns nullptr if queue is empty or a producer has not completed the
+    // push yet.
+    node * pop ()
+    {
+        auto tail = _tail;
+        auto next = tail->next.load(std::memory_order_acquire);
+
+        if (tail == & _stub) {
+            if (next == nullptr)
+                return nullptr;
+
+            _tail = next;
+            tail = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+
+        if (next != nullptr) {
+            _tail = next;
+            return tail;
+        }
+
+        if (tail != _head.load(std::memory_order_acquire))
+            return nullptr;
+
+        push_node(& _stub);
+
+        next = tail->next.load(std::memory_order_acquire);
+
+        if (next != nullptr) {
+            _tail = next;
+            return tail;
+        }
+
+        return nullptr;
+    }
+
+    // Calls at most @a max_count actions pushed before this call.
+    std::size_t call_helper (std::size_t max_count)
+    {
+        std::size_t counter = 0;
+        auto last = _head.load(std::memory_order_acquire);
+
+        while (counter < max_count) {
+            // Stub was the last node at the snapshot moment, so the remaining
+            // nodes are pushed after the snapshot
+            if (last == & _stub && _tail == & _stub)
+                break;
+
+            auto n = pop();
+
+            if (n == nullptr)
+                break;
+
+            bool is_last = (n == last);
+
+            n->invoke();
+            delete n;
+            ++counter;
+
+            if (is_last)
+                break;
+        }
+
+        return counter;
+    }
+
+public:
+    mpsc_function_queue ()
+        : _head(& _stub)
+        , _padding{}
+        , _tail(& _stub)
+    {}
+
+    mpsc_function_queue (mpsc_function_queue const &) = delete;
+    mpsc_function_queue & operator = (mpsc_function_queue const &) = delete;
+    mpsc_function_queue (mpsc_function_queue &&) = delete;
+    mpsc_function_queue & operator = (mpsc_function_queue &&) = delete;
+
+    ~mpsc_function_queue ()
+    {
+        node * n = nullptr;
+
+        while ((n = pop()) != nullptr)
+            delete n;
+    }
+
+    template <typename F, typename ...Args>
+    void push (F && f, Args &&... args)
+    {
+        auto fn = std::bind(std::forward<F>(f), std::forward<Args>(args)...);
+        push_node(new function_node<decltype(fn)>(std::move(fn)));
+        notify();
+    }
+
+    bool empty () const
+    {
+        return _tail == & _stub
+            && _stub.next.load(std::memory_order_acquire) == nullptr
+            && _head.load(std::memory_order_seq_cst) == & _stub;
+    }
+
+    std::size_t call ()
+    {
+        return call_helper(1);
+    }
+
+    std::size_t call (int max_count)
+    {
+        return max_count > 0 ? call_helper(static_cast<std::size_t>(max_count)) : 0;
+    }
+
+    /**
+     * Calls all actions pushed before this call. Actions pushed while calling
+     * are left for the next call, so continuous producers can not lock the
+     * consumer inside this method.
+     */
+    std::size_t call_all ()
+    {
+        return call_helper(static_cast<std::size_t>(-1));
+    }
+
+    void wait ()
+    {
+        if (!empty())
+            return;
+
+        std::unique_lock<std::mutex> locker(_mtx);
+        _parked.store(true, std::memory_order_seq_cst);
+        _cond.wait(locker, [this] { return !empty(); });
+        _parked.store(false, std::memory_order_relaxed);
+    }
+
+    /**
+     * Waits at most @a microseconds for actions.
+     *
+     * @return @c true if queue is not empty.
+     */
+    bool wait_for (intmax_t microseconds)
+    {
+        if (!empty())
+            return true;
+
+        std::unique_lock<std::mutex> locker(_mtx);
+        _parked.store(true, std::memory_order_seq_cst);
+        auto result = _cond.wait_for(locker, std::chrono::microseconds(microseconds)
+            , [this] { return !empty(); });
+        _parked.store(false, std::memory_order_relaxed);
+
+        return result;
+    }
+};
+
+MODULUS__NAMESPACE_END
@@ -0,0 +1,32 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Vladislav Trifochkin
+//
+// License: see LICENSE file
+//
+// This file is part of `modulus2-lib`.
+//
+// Changelog:
+//      2026.10.17 Initial version.
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "namespace.hpp"
+#include <memory>
+#include <utility>
+
+MODULUS__NAMESPACE_BEGIN
+
+/**
+ * Immutable reference-counted message payload. Emitting payload copies
+ * the reference only, so all detectors (including queued ones) share the
+ * single instance of the message.
+ */
+template <typename T>
+using payload = std::shared_ptr<T const>;
+
+template <typename T, typename ...Args>
+inline payload<T> make_payload (Args &&... args)
+{
+    return std::make_shared<T const>(std::forward<Args>(args)...);
+}
+
+MODULUS__NAMESPACE_END
@@ -0,0 +1,267 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Vladislav Trifochkin
+//
+// License: see LICENSE file
+//
+// This file is part of `modulus2-lib`.
+//
+// Changelog:
+//      2026.10.17 Initial version.
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "namespace.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#if __linux__
+#   include <sys/epoll.h>
+#   include <sys/eventfd.h>
+#   include <unistd.h>
+#   include <cerrno>
+#   include <cstring>
+#   define MODULUS__REACTOR_ENABLED 1
+#endif
+
+MODULUS__NAMESPACE_BEGIN
+
+/**
+ * Events of the file descriptor watched by reactor (flags).
+ */
+enum io_event: unsigned
+{
+      io_read  = 1u << 0 // Readable (including end of stream)
+    , io_write = 1u << 1 // Writable
+    , io_error = 1u << 2 // Error or hang up (reported even if not requested)
+};
+
+#if MODULUS__REACTOR_ENABLED
+
+/**
+ * Waits for events of the watched file descriptors and for notification
+ * (e.g. about action pushed into the module queue, see notify()) in the single
+ * epoll_wait() call. Callbacks are called by the thread calling wait().
+ *
+ * watch(), modify() and unwatch() must be called by the thread calling wait()
+ * (e.g. from callbacks) or while nobody calls wait().
+ */
+class reactor
+{
+public:
+    using callback_type = std::function<void(unsigned /*io_event flags*/)>;
+
+private:
+    static constexpr int max_events = 64;
+
+    int _epfd {-1};
+    int _evfd {-1};
+
+    // Waiting thread must be woken up by notify()
+    std::atomic<bool> _sleeping {false};
+
+    // Callback can unwatch own descriptor, so it is kept alive by shared
+    // pointer while it is called
+    std::unordered_map<int, std::shared_ptr<callback_type>> _callbacks;
+
+private:
+    static std::string error_string (char const * func)
+    {
+        return std::string{func} + " failure: " + std::strerror(errno);
+    }
+
+    static std::uint32_t to_epoll_events (unsigned events)
+    {
+        std::uint32_t result = 0;
+
+        if (events & io_read)
+            result |= EPOLLIN | EPOLLRDHUP;
+
+        if (events & io_write)
+            result |= EPOLLOUT;
+
+        return result;
+    }
+
+    static unsigned from_epoll_events (std::uint32_t events)
+    {
+        unsigned result = 0;
+
+        if (events & (EPOLLIN | EPOLLPRI | EPOLLRDHUP))
+            result |= io_read;
+
+        if (events & EPOLLOUT)
+            result |= io_write;
+
+        if (events & (EPOLLERR | EPOLLHUP))
+            result |= io_error;
+
+        return result;
+    }
+
+public:
+    reactor () = default;
+
+    reactor (reactor const &) = delete;
+    reactor & operator = (reactor const &) = delete;
+    reactor (reactor &&) = delete;
+    reactor & operator = (reactor &&) = delete;
+
+    ~reactor ()
+    {
+        if (_evfd >= 0)
+            ::close(_evfd);
+
+        if (_epfd >= 0)
+            ::close(_epfd);
+    }
+
+    /**
+     * Creates epoll instance and event descriptor for notifications.
+     *
+     * @return Error description or empty string on success.
+     */
+    std::string open ()
+    {
+        _epfd = ::epoll_create1(EPOLL_CLOEXEC);
+
+        if (_epfd < 0)
+            return error_string("epoll_create1");
+
+        _evfd = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+        if (_evfd < 0)
+            return error_string("eventfd");
+
+        epoll_event ev {};
+        ev.events = EPOLLIN;
+        ev.data.fd = _evfd;
+
+        if (::epoll_ctl(_epfd, EPOLL_CTL_ADD, _evfd, & ev) < 0)
+            return error_string("epoll_ctl");
+
+        return std::string{};
+    }
+
+    /**
+     * Starts watching @a fd for @a events (combination of io_event flags).
+     *
+     * @return Error description or empty string on success.
+     */
+    std::string watch (int fd, unsigned events, callback_type && callback)
+    {
+        epoll_event ev {};
+        ev.events = to_epoll_events(events);
+        ev.data.fd = fd;
+
+        if (::epoll_ctl(_epfd, EPOLL_CTL_ADD, fd, & ev) < 0)
+            return error_string("epoll_ctl");
+
+        _callbacks[fd] = std::make_shared<callback_type>(std::move(callback));
+        return std::string{};
+    }
+
+    /**
+     * Changes events watched for @a fd (e.g. enables io_write while there
+     * is data to send).
+     */
+    std::string modify (int fd, unsigned events)
+    {
+        epoll_event ev {};
+        ev.events = to_epoll_events(events);
+        ev.data.fd = fd;
+
+        if (::epoll_ctl(_epfd, EPOLL_CTL_MOD, fd, & ev) < 0)
+            return error_string("epoll_ctl");
+
+        return std::string{};
+    }
+
+    /**
+     * Stops watching @a fd. Must be called before @a fd is closed.
+     */
+    std::string unwatch (int fd)
+    {
+        _callbacks.erase(fd);
+
+        if (::epoll_ctl(_epfd, EPOLL_CTL_DEL, fd, nullptr) < 0)
+            return error_string("epoll_ctl");
+
+        return std::string{};
+    }
+
+    std::size_t watched_count () const noexcept
+    {
+        return _callbacks.size();
+    }
+
+    /**
+     * Wakes up the thread waiting in wait(). Writes to the event descriptor
+     * only if the thread is waiting, so it is cheap to call on each push into
+     * the queue. Can be called from any thread.
+     */
+    void notify ()
+    {
+        if (_sleeping.exchange(false)) {
+            std::uint64_t one = 1;
+
+            // EAGAIN (counter overflow) means already notified
+            auto rc = ::write(_evfd, & one, sizeof(one));
+            (void)rc;
+        }
+    }
+
+    /**
+     * Waits at most @a timeout_ms milliseconds (negative means infinitely)
+     * for events or notification and calls callbacks of the ready file
+     * descriptors. Does not block if @a ready returns @c true: it is checked
+     * after the thread is marked as waiting, so notification can't be lost.
+     *
+     * @return Number of called callbacks.
+     */
+    template <typename Ready>
+    int wait (int timeout_ms, Ready && ready)
+    {
+        _sleeping.store(true);
+
+        if (ready())
+            timeout_ms = 0;
+
+        epoll_event events[max_events];
+        auto n = ::epoll_wait(_epfd, events, max_events, timeout_ms);
+
+        _sleeping.store(false);
+
+        int count = 0;
+
+        for (int i = 0; i < n; i++) {
+            auto fd = events[i].data.fd;
+
+            if (fd == _evfd) {
+                std::uint64_t value = 0;
+                auto rc = ::read(_evfd, & value, sizeof(value));
+                (void)rc;
+                continue;
+            }
+
+            auto pos = _callbacks.find(fd);
+
+            // Unwatched by one of the previous callbacks
+            if (pos == _callbacks.end())
+                continue;
+
+            auto callback = pos->second;
+            (*callback)(from_epoll_events(events[i].events));
+            ++count;
+        }
+
+        return count;
+    }
+};
+
+#endif // MODULUS__REACTOR_ENABLED
+
+MODULUS__NAMESPACE_END
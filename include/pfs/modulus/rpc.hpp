@@ -0,0 +1,154 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Vladislav Trifochkin
+//
+// License: see LICENSE file
+//
+// This file is part of `modulus2-lib`.
+//
+// Changelog:
+//      2026.10.17 Initial version.
+//      2026.10.17 Added status of the reply dropped by the caller's queue.
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "namespace.hpp"
+#include <cassert>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+MODULUS__NAMESPACE_BEGIN
+
+/**
+ * Status of the remote procedure call (see modulus::rpc_emitter).
+ */
+enum class rpc_status
+{
+      success
+    , timeout // No reply received in time
+    , dropped // Reply dropped or rejected by overflow policy (or expired)
+              // in the caller's queue
+};
+
+/**
+ * Result of the remote procedure call: status and returned value (valid for
+ * rpc_status::success only).
+ */
+template <typename R>
+class rpc_result
+{
+    rpc_status _status {rpc_status::timeout};
+    bool _has_value {false};
+    typename std::aligned_storage<sizeof(R), alignof(R)>::type _storage;
+
+private:
+    R * ptr () noexcept
+    {
+        return reinterpret_cast<R *>(& _storage);
+    }
+
+    R const * ptr () const noexcept
+    {
+        return reinterpret_cast<R const *>(& _storage);
+    }
+
+    void reset () noexcept
+    {
+        if (_has_value) {
+            ptr()->~R();
+            _has_value = false;
+        }
+    }
+
+public:
+    rpc_result () = default;
+
+    explicit rpc_result (rpc_status status)
+        : _status(status)
+    {}
+
+    explicit rpc_result (R && value)
+        : _status(rpc_status::success)
+        , _has_value(true)
+    {
+        new (& _storage) R(std::move(value));
+    }
+
+    rpc_result (rpc_result && other)
+        : _status(other._status)
+    {
+        if (other._has_value) {
+            new (& _storage) R(std::move(*other.ptr()));
+            _has_value = true;
+        }
+    }
+
+    rpc_result & operator = (rpc_result && other)
+    {
+        if (this != & other) {
+            reset();
+            _status = other._status;
+
+            if (other._has_value) {
+                new (& _storage) R(std::move(*other.ptr()));
+                _has_value = true;
+            }
+        }
+
+        return *this;
+    }
+
+    rpc_result (rpc_result const &) = delete;
+    rpc_result & operator = (rpc_result const &) = delete;
+
+    ~rpc_result ()
+    {
+        reset();
+    }
+
+    rpc_status status () const noexcept
+    {
+        return _status;
+    }
+
+    bool ok () const noexcept
+    {
+        return _status == rpc_status::success;
+    }
+
+    R & value ()
+    {
+        assert(_has_value);
+        return *ptr();
+    }
+
+    R const & value () const
+    {
+        assert(_has_value);
+        return *ptr();
+    }
+};
+
+template <>
+class rpc_result<void>
+{
+    rpc_status _status {rpc_status::timeout};
+
+public:
+    rpc_result () = default;
+
+    explicit rpc_result (rpc_status status)
+        : _status(status)
+    {}
+
+    rpc_status status () const noexcept
+    {
+        return _status;
+    }
+
+    bool ok () const noexcept
+    {
+        return _status == rpc_status::success;
+    }
+};
+
+MODULUS__NAMESPACE_END
@@ -0,0 +1,192 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Vladislav Trifochkin
+//
+// License: see LICENSE file
+//
+// This file is part of `modulus2-lib`.
+//
+// Changelog:
+//      2026.10.17 Initial version.
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "namespace.hpp"
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if __linux__
+#   include <linux/mempolicy.h>
+#   include <pthread.h>
+#   include <sched.h>
+#   include <sys/syscall.h>
+#   include <unistd.h>
+#   include <cerrno>
+#   include <cstring>
+#   define MODULUS__THREAD_PLACEMENT_ENABLED 1
+#endif
+
+MODULUS__NAMESPACE_BEGIN
+
+/**
+ * Thread placement for dispatcher and runnable modules running in dedicated
+ * threads.
+ */
+struct placement_options
+{
+    // CPUs the thread is allowed to run on, empty means any (or all CPUs of
+    // the NUMA node if specified).
+    std::vector<int> cpu_set;
+
+    // NUMA node to run the thread on and to allocate the thread's memory
+    // from, negative value means any.
+    int numa_node {-1};
+
+    // SCHED_FIFO priority, zero means default scheduling policy.
+    int fifo_priority {0};
+
+    bool empty () const noexcept
+    {
+        return cpu_set.empty() && numa_node < 0 && fifo_priority == 0;
+    }
+};
+
+/**
+ * Parses CPU list in the Linux format (e.g. "0-3,8,10-11").
+ *
+ * @return @c false if @a s has bad format.
+ */
+inline bool parse_cpu_list (std::string const & s, std::vector<int> & result)
+{
+    std::vector<int> cpus;
+    char const * p = s.c_str();
+
+    while (*p != '\0' && *p != '\n') {
+        char * end = nullptr;
+        auto first = std::strtol(p, & end, 10);
+
+        if (end == p || first < 0)
+            return false;
+
+        auto last = first;
+        p = end;
+
+        if (*p == '-') {
+            ++p;
+            last = std::strtol(p, & end, 10);
+
+            if (end == p || last < first)
+                return false;
+
+            p = end;
+        }
+
+        for (auto cpu = first; cpu <= last; cpu++)
+            cpus.push_back(static_cast<int>(cpu));
+
+        if (*p == ',')
+            ++p;
+        else if (*p != '\0' && *p != '\n')
+            return false;
+    }
+
+    result = std::move(cpus);
+    return true;
+}
+
+#if MODULUS__THREAD_PLACEMENT_ENABLED
+
+/**
+ * Applies placement options to the current thread.
+ *
+ * @return Error description or empty string on success.
+ */
+inline std::string apply_thread_placement (placement_options const & opts)
+{
+    std::vector<int> cpus = opts.cpu_set;
+
+    if (opts.numa_node >= 0) {
+        std::ifstream ifs {"/sys/devices/system/node/node" + std::to_string(opts.numa_node) + "/cpulist"};
+        std::string cpulist;
+        std::vector<int> node_cpus;
+
+        if (!ifs || !std::getline(ifs, cpulist) || !parse_cpu_list(cpulist, node_cpus))
+            return "failed to read CPU list for NUMA node " + std::to_string(opts.numa_node);
+
+        if (cpus.empty()) {
+            cpus = std::move(node_cpus);
+        } else {
+            // Intersect requested CPUs with node's ones
+            std::vector<int> intersection;
+
+            for (auto cpu: cpus) {
+                for (auto node_cpu: node_cpus) {
+                    if (cpu == node_cpu) {
+                        intersection.push_back(cpu);
+                        break;
+                    }
+                }
+            }
+
+            if (intersection.empty())
+                return "no requested CPU belongs to NUMA node " + std::to_string(opts.numa_node);
+
+            cpus = std::move(intersection);
+        }
+
+        // Prefer memory allocations from the node
+        unsigned long nodemask[16] = {0};
+        auto const bits_per_mask = 8 * sizeof(unsigned long);
+
+        if (static_cast<std::size_t>(opts.numa_node) >= bits_per_mask * 16)
+            return "NUMA node number is too big: " + std::to_string(opts.numa_node);
+
+        nodemask[opts.numa_node / bits_per_mask] |= 1UL << (opts.numa_node % bits_per_mask);
+
+        if (syscall(SYS_set_mempolicy, MPOL_PREFERRED, nodemask, bits_per_mask * 16) != 0)
+            return std::string{"set_mempolicy failure: "} + std::strerror(errno);
+    }
+
+    if (!cpus.empty()) {
+        cpu_set_t cpuset;
+        CPU_ZERO(& cpuset);
+
+        for (auto cpu: cpus) {
+            if (cpu < 0 || cpu >= CPU_SETSIZE)
+                return "bad CPU number: " + std::to_string(cpu);
+
+            CPU_SET(cpu, & cpuset);
+        }
+
+        auto rc = pthread_setaffinity_np(pthread_self(), sizeof(cpuset), & cpuset);
+
+        if (rc != 0)
+            return std::string{"set thread affinity failure: "} + std::strerror(rc);
+    }
+
+    if (opts.fifo_priority != 0) {
+        sched_param param;
+        std::memset(& param, 0, sizeof(param));
+        param.sched_priority = opts.fifo_priority;
+
+        auto rc = pthread_setschedparam(pthread_self(), SCHED_FIFO, & param);
+
+        if (rc != 0)
+            return std::string{"set SCHED_FIFO priority failure: "} + std::strerror(rc);
+    }
+
+    return std::string{};
+}
+
+#else
+
+inline std::string apply_thread_placement (placement_options const & opts)
+{
+    return opts.empty() ? std::string{} : std::string{"thread placement is not supported on this platform"};
+}
+
+#endif // MODULUS__THREAD_PLACEMENT_ENABLED
+
+MODULUS__NAMESPACE_END
@@ -0,0 +1,246 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Vladislav Trifochkin
+//
+// License: see LICENSE file
+//
+// This file is part of `modulus2-lib`.
+//
+// Changelog:
+//      2026.10.17 Initial version.
+//      2026.10.17 Added periodic timer modes.
+//      2026.10.17 Timer callbacks are not limited by queue capacity.
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "namespace.hpp"
+#include "timing_wheel.hpp"
+#include <pfs/timer_pool.hpp>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+MODULUS__NAMESPACE_BEGIN
+
+/**
+ * Timer implementation used by the dispatcher.
+ */
+enum class timer_backend
+{
+      timer_pool   // pfs::timer_pool (default)
+    , timing_wheel // Hierarchical timing wheel, O(1) arm/cancel
+};
+
+/**
+ * Converts @a d to microseconds rounding up.
+ */
+template <typename Rep, typename Period>
+inline std::chrono::microseconds ceil_microseconds (std::chrono::duration<Rep, Period> d)
+{
+    auto result = std::chrono::duration_cast<std::chrono::microseconds>(d);
+
+    if (result < d)
+        ++result;
+
+    return result;
+}
+
+/**
+ * Timer backend interface. Expired timer callback is pushed into the queue
+ * specified at creation (regardless of its capacity, see
+ * module_queue::push_unbounded()) or called directly from the timer thread if
+ * the queue is null.
+ */
+template <typename QueueType>
+class basic_timer_backend
+{
+public:
+    using timer_id = pfs::timer_pool::timer_id;
+    using callback_type = pfs::timer_pool::callback_type;
+
+public:
+    virtual ~basic_timer_backend () {}
+
+    /**
+     * Creates timer expired after @a delay and then periodically with
+     * @a period if it is not zero. Timer in timer_mode::fixed_delay mode
+     * is suspended after each expiration until resume() called.
+     */
+    virtual timer_id create (std::chrono::microseconds delay
+        , std::chrono::microseconds period
+        , timer_mode mode
+        , QueueType * callback_queue
+        , callback_type && callback) = 0;
+
+    /**
+     * Re-arms the expired timer created in timer_mode::fixed_delay mode.
+     */
+    virtual void resume (timer_id id) = 0;
+
+    virtual void destroy (timer_id id) = 0;
+    virtual void destroy_all () = 0;
+};
+
+template <typename QueueType>
+class timer_pool_backend: public basic_timer_backend<QueueType>
+{
+    using base_class = basic_timer_backend<QueueType>;
+
+public:
+    using timer_id = typename base_class::timer_id;
+    using callback_type = typename base_class::callback_type;
+
+private:
+    struct callback_helper
+    {
+        callback_type callback;
+        QueueType * callback_queue {nullptr};
+
+        void operator () ()
+        {
+            if (callback_queue) {
+                callback_queue->push_unbounded(callback);
+            } else {
+                callback();
+            }
+        }
+    };
+
+    // Fixed-delay timer is emulated by the chain of single shot timers,
+    // identifier of the first one is used as the timer identifier
+    // (pfs::timer_pool does not reuse identifiers).
+    struct fixed_delay_timer
+    {
+        std::chrono::microseconds period;
+        QueueType * callback_queue;
+        callback_type callback;
+        timer_id current_id {0};
+    };
+
+    pfs::timer_pool _pool;
+    std::mutex _mtx;
+    std::map<timer_id, std::shared_ptr<fixed_delay_timer>> _fixed_delay_timers;
+
+private:
+    // pfs::timer_pool has millisecond resolution
+    static std::chrono::milliseconds to_milliseconds (std::chrono::microseconds d)
+    {
+        return std::chrono::milliseconds{(d.count() + 999) / 1000};
+    }
+
+public:
+    timer_id create (std::chrono::microseconds delay
+        , std::chrono::microseconds period
+        , timer_mode mode
+        , QueueType * callback_queue
+        , callback_type && callback) override
+    {
+        callback_helper helper;
+        helper.callback_queue = callback_queue;
+        helper.callback = std::move(callback);
+
+        if (period.count() > 0 && mode == timer_mode::fixed_delay) {
+            auto t = std::make_shared<fixed_delay_timer>();
+            t->period = period;
+            t->callback_queue = callback_queue;
+            t->callback = helper.callback;
+
+            std::unique_lock<std::mutex> locker(_mtx);
+            auto id = _pool.create(to_milliseconds(delay), std::move(helper));
+            t->current_id = id;
+            _fixed_delay_timers[id] = std::move(t);
+            return id;
+        }
+
+        if (period.count() > 0)
+            return _pool.create(to_milliseconds(delay), to_milliseconds(period), std::move(helper));
+
+        return _pool.create(to_milliseconds(delay), std::move(helper));
+    }
+
+    void resume (timer_id id) override
+    {
+        std::unique_lock<std::mutex> locker(_mtx);
+        auto pos = _fixed_delay_timers.find(id);
+
+        if (pos == _fixed_delay_timers.end())
+            return;
+
+        auto & t = *pos->second;
+        callback_helper helper;
+        helper.callback_queue = t.callback_queue;
+        helper.callback = t.callback;
+        t.current_id = _pool.create(to_milliseconds(t.period), std::move(helper));
+    }
+
+    void destroy (timer_id id) override
+    {
+        std::unique_lock<std::mutex> locker(_mtx);
+        auto pos = _fixed_delay_timers.find(id);
+
+        if (pos != _fixed_delay_timers.end()) {
+            _pool.destroy(pos->second->current_id);
+            _fixed_delay_timers.erase(pos);
+            return;
+        }
+
+        _pool.destroy(id);
+    }
+
+    void destroy_all () override
+    {
+        std::unique_lock<std::mutex> locker(_mtx);
+        _fixed_delay_timers.clear();
+        _pool.destroy_all();
+    }
+};
+
+template <typename QueueType>
+class timing_wheel_backend: public basic_timer_backend<QueueType>
+{
+    using base_class = basic_timer_backend<QueueType>;
+
+public:
+    using timer_id = typename base_class::timer_id;
+    using callback_type = typename base_class::callback_type;
+
+private:
+    timing_wheel<timer_id> _wheel;
+
+public:
+    timing_wheel_backend (std::chrono::microseconds resolution)
+        : _wheel(resolution, [] (void * target, callback_type & callback) {
+            if (target) {
+                static_cast<QueueType *>(target)->push_unbounded(callback);
+            } else {
+                callback();
+            }
+        })
+    {}
+
+    timer_id create (std::chrono::microseconds delay
+        , std::chrono::microseconds period
+        , timer_mode mode
+        , QueueType * callback_queue
+        , callback_type && callback) override
+    {
+        return _wheel.create(delay, period, mode, callback_queue, std::move(callback));
+    }
+
+    void resume (timer_id id) override
+    {
+        _wheel.resume(id);
+    }
+
+    void destroy (timer_id id) override
+    {
+        _wheel.destroy(id);
+    }
+
+    void destroy_all () override
+    {
+        _wheel.destroy_all();
+    }
+};
+
+MODULUS__NAMESPACE_END
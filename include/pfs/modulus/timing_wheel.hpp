@@ -0,0 +1,601 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Vladislav Trifochkin
+//
+// License: see LICENSE file
+//
+// This file is part of `modulus2-lib`.
+//
+// Changelog:
+//      2026.10.17 Initial version.
+//      2026.10.17 Added fixed-delay mode.
+//      2026.10.17 Wheel thread sleeps until the next non-empty slot.
+//      2026.10.17 Documented catch-up of fixed-rate periodic timers.
+//      2026.10.17 Fixed-delay timer resumed while its callback is dispatched.
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "namespace.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+MODULUS__NAMESPACE_BEGIN
+
+/**
+ * Periodic timer mode.
+ */
+enum class timer_mode
+{
+      fixed_rate  // Expirations are aligned to the start time (no drift).
+                  // Timer backend coalesces overdue expirations, periodic
+                  // timers of modules call them in burst (catch-up, see
+                  // dispatcher::set_timer_catch_up_limit())
+    , fixed_delay // Next expiration is scheduled after the previous one
+                  // is processed (see timing_wheel::resume())
+};
+
+/**
+ * Hierarchical timing wheel (4 levels of 256 slots) with own thread.
+ *
+ * Arming and cancelling a timer is O(1), expired timers are cascaded from
+ * upper levels once per 256 ticks of the level below. The wheel thread sleeps
+ * until the nearest tick that has timers to expire or to cascade, so armed
+ * long timer does not wake it up every tick. Timer entries are
+ * allocated from the internal pool and reused, so no allocation is needed
+ * for a timer except for its callback.
+ *
+ * Timer identifier encodes entry index and its generation, so destroying of
+ * already expired timer never affects the timer that reused the entry.
+ *
+ * @tparam TimerIdType Integral type of timer identifier. Zero is never used
+ *         as a valid identifier.
+ */
+template <typename TimerIdType = std::uint64_t>
+class timing_wheel
+{
+public:
+    using timer_id = TimerIdType;
+    using callback_type = std::function<void()>;
+
+    // Called for the expired timer to deliver the callback with the target
+    // specified while timer creation (e.g. function queue)
+    using dispatch_type = std::function<void(void * /*target*/, callback_type &)>;
+
+private:
+    using clock_type = std::chrono::steady_clock;
+
+    static constexpr int slot_bits = 8;
+    static constexpr std::size_t slot_count = 1 << slot_bits;
+    static constexpr std::size_t slot_mask = slot_count - 1;
+    static constexpr int level_count = 4;
+
+    static constexpr int id_digits = std::numeric_limits<timer_id>::digits;
+    static constexpr int index_bits = id_digits >= 48 ? 32 : 20;
+
+    enum class entry_state: std::uint8_t { free, armed, firing, cancelled, suspended };
+
+    struct entry
+    {
+        entry * prev {nullptr};
+        entry * next {nullptr};
+        entry ** slot {nullptr}; // Head of the slot list the entry linked to
+        std::uint64_t expiry {0}; // In ticks
+        std::uint64_t period {0}; // In ticks, zero for single shot timer
+        timer_mode mode {timer_mode::fixed_rate};
+        std::uint32_t index {0};
+        std::uint32_t generation {0};
+        entry_state state {entry_state::free};
+        bool resume_requested {false}; // Resumed while firing (fixed-delay)
+        void * target {nullptr};
+        callback_type callback;
+    };
+
+private:
+    std::chrono::microseconds _resolution;
+    clock_type::time_point _start;
+    std::uint64_t _now_tick {0};
+
+    entry * _slots[level_count][slot_count];
+    std::deque<entry> _entries;
+    std::vector<entry *> _free_entries;
+    std::size_t _armed_count {0};
+
+    dispatch_type _dispatch;
+
+    std::mutex _mtx;
+    std::condition_variable _cond;
+    bool _stop {false};
+    std::thread _thread;
+
+    // Tick the wheel thread sleeps until (must be woken up if the timer
+    // expiring earlier is armed)
+    std::uint64_t _wake_tick {(std::numeric_limits<std::uint64_t>::max)()};
+    std::size_t _wakeup_count {0};
+
+private:
+    std::uint64_t tick_of (clock_type::time_point t) const
+    {
+        return static_cast<std::uint64_t>((t - _start) / _resolution);
+    }
+
+    std::uint64_t to_ticks (std::chrono::microseconds d) const
+    {
+        if (d.count() <= 0)
+            return 0;
+
+        return static_cast<std::uint64_t>((d.count() + _resolution.count() - 1) / _resolution.count());
+    }
+
+    timer_id make_id (entry const * e) const
+    {
+        auto generation_mask = (std::uint64_t{1} << (id_digits - index_bits)) - 1;
+        return static_cast<timer_id>(((e->generation & generation_mask) << index_bits)
+            | (std::uint64_t{e->index} + 1));
+    }
+
+    entry * find_entry (timer_id id)
+    {
+        auto index_mask = (std::uint64_t{1} << index_bits) - 1;
+        auto generation_mask = (std::uint64_t{1} << (id_digits - index_bits)) - 1;
+        auto raw = static_cast<std::uint64_t>(id);
+        auto index = raw & index_mask;
+
+        if (index == 0 || index > _entries.size())
+            return nullptr;
+
+        auto e = & _entries[index - 1];
+
+        if ((e->generation & generation_mask) != ((raw >> index_bits) & generation_mask))
+            return nullptr;
+
+        return e;
+    }
+
+    entry * acquire_entry ()
+    {
+        if (!_free_entries.empty()) {
+            auto e = _free_entries.back();
+            _free_entries.pop_back();
+            return e;
+        }
+
+        if (_entries.size() >= (std::uint64_t{1} << index_bits) - 1)
+            return nullptr;
+
+        _entries.emplace_back();
+        auto e = & _entries.back();
+        e->index = static_cast<std::uint32_t>(_entries.size() - 1);
+        return e;
+    }
+
+    void release_entry (entry * e)
+    {
+        e->state = entry_state::free;
+        e->resume_requested = false;
+        e->callback = nullptr;
+        e->target = nullptr;
+        ++e->generation;
+        _free_entries.push_back(e);
+    }
+
+    void link (entry * e)
+    {
+        auto delta = e->expiry > _now_tick ? e->expiry - _now_tick : 1;
+        int level = 0;
+
+        while (level < level_count - 1 && delta >= (std::uint64_t{1} << (slot_bits * (level + 1))))
+            ++level;
+
+        // Expiry beyond the last level is clamped, the entry is re-linked
+        // while cascading
+        auto expiry = e->expiry;
+
+        if (delta >= (std::uint64_t{1} << (slot_bits * level_count)))
+            expiry = _now_tick + (std::uint64_t{1} << (slot_bits * level_count)) - 1;
+
+        auto & head = _slots[level][(expiry >> (slot_bits * level)) & slot_mask];
+
+        e->prev = nullptr;
+        e->next = head;
+        e->slot = & head;
+
+        if (head != nullptr)
+            head->prev = e;
+
+        head = e;
+    }
+
+    void unlink (entry * e)
+    {
+        if (e->prev != nullptr)
+            e->prev->next = e->next;
+        else
+            *e->slot = e->next;
+
+        if (e->next != nullptr)
+            e->next->prev = e->prev;
+
+        e->prev = e->next = nullptr;
+        e->slot = nullptr;
+    }
+
+    // Advances wheel by one tick and collects expired entries into @a fired
+    void advance (std::vector<entry *> & fired)
+    {
+        ++_now_tick;
+
+        // Cascade upper levels
+        for (int level = 1; level < level_count; level++) {
+            if (((_now_tick >> (slot_bits * (level - 1))) & slot_mask) != 0)
+                break;
+
+            auto & head = _slots[level][(_now_tick >> (slot_bits * level)) & slot_mask];
+            auto e = head;
+            head = nullptr;
+
+            while (e != nullptr) {
+                auto next = e->next;
+                link(e);
+                e = next;
+            }
+        }
+
+        auto & head = _slots[0][_now_tick & slot_mask];
+        auto e = head;
+        head = nullptr;
+
+        while (e != nullptr) {
+            auto next = e->next;
+            e->prev = e->next = nullptr;
+            e->slot = nullptr;
+
+            if (e->expiry <= _now_tick) {
+                e->state = entry_state::firing;
+                --_armed_count;
+                fired.push_back(e);
+            } else {
+                link(e);
+            }
+
+            e = next;
+        }
+    }
+
+    // Returns the nearest tick after the current one that has entries to
+    // expire (level 0) or to cascade (upper levels). Upper level slot is
+    // cascaded at the tick with zero lower digits.
+    std::uint64_t next_event_tick () const
+    {
+        auto result = (std::numeric_limits<std::uint64_t>::max)();
+
+        for (std::uint64_t tick = _now_tick + 1; tick <= _now_tick + slot_count; tick++) {
+            if (_slots[0][tick & slot_mask] != nullptr) {
+                result = tick;
+                break;
+            }
+        }
+
+        for (int level = 1; level < level_count; level++) {
+            auto shift = slot_bits * level;
+            auto tick = ((_now_tick >> shift) + 1) << shift;
+
+            for (std::size_t i = 0; i < slot_count && tick < result; i++) {
+                if (_slots[level][(tick >> shift) & slot_mask] != nullptr) {
+                    result = tick;
+                    break;
+                }
+
+                tick += std::uint64_t{1} << shift;
+            }
+        }
+
+        return result;
+    }
+
+    // Links entry to expire after @a delay from now, must be called with
+    // mutex locked
+    void arm (entry * e, std::chrono::microseconds delay)
+    {
+        bool was_idle = (_armed_count == 0);
+        auto now_tick = tick_of(clock_type::now());
+
+        // No need to process the elapsed ticks when no timer armed
+        if (was_idle && now_tick > _now_tick)
+            _now_tick = now_tick;
+
+        // Expiration tick is rounded up, so timer never expires earlier
+        // than requested
+        auto due = std::chrono::duration_cast<std::chrono::microseconds>(clock_type::now() - _start) + delay;
+        auto expiry = to_ticks(due);
+
+        e->expiry = expiry > _now_tick ? expiry : _now_tick + 1;
+        e->state = entry_state::armed;
+
+        link(e);
+        ++_armed_count;
+
+        if (was_idle || e->expiry < _wake_tick)
+            _cond.notify_all();
+    }
+
+    void run ()
+    {
+        std::vector<entry *> fired;
+        std::unique_lock<std::mutex> locker(_mtx);
+
+        while (!_stop) {
+            auto next_tick = _armed_count > 0
+                ? next_event_tick()
+                : (std::numeric_limits<std::uint64_t>::max)();
+
+            if (next_tick == (std::numeric_limits<std::uint64_t>::max)()) {
+                _wake_tick = next_tick;
+                _cond.wait(locker);
+                ++_wakeup_count;
+                continue;
+            }
+
+            auto next_time = _start + next_tick * _resolution;
+
+            if (clock_type::now() < next_time) {
+                _wake_tick = next_tick;
+                _cond.wait_until(locker, next_time);
+                ++_wakeup_count;
+                continue;
+            }
+
+            auto target_tick = tick_of(clock_type::now());
+
+            // Ticks without expired and cascaded entries are skipped
+            while (_now_tick < target_tick && _armed_count > 0) {
+                next_tick = next_event_tick();
+
+                if (next_tick > target_tick) {
+                    _now_tick = target_tick;
+                    break;
+                }
+
+                _now_tick = next_tick - 1;
+                advance(fired);
+            }
+
+            if (_armed_count == 0)
+                _now_tick = target_tick;
+
+            if (fired.empty())
+                continue;
+
+            locker.unlock();
+
+            for (auto e: fired)
+                _dispatch(e->target, e->callback);
+
+            locker.lock();
+
+            for (auto e: fired) {
+                if (e->state != entry_state::firing || e->period == 0) {
+                    release_entry(e);
+                } else if (e->mode == timer_mode::fixed_delay) {
+                    // Callback (delivered to the queue) may be processed and
+                    // resume the timer before the dispatch loop finished
+                    if (e->resume_requested) {
+                        e->resume_requested = false;
+                        arm(e, e->period * _resolution);
+                    } else {
+                        e->state = entry_state::suspended;
+                    }
+                } else {
+                    e->state = entry_state::armed;
+                    e->expiry += e->period;
+
+                    // Skip overdue expirations keeping the phase
+                    if (e->expiry <= _now_tick)
+                        e->expiry += ((_now_tick - e->expiry) / e->period + 1) * e->period;
+
+                    link(e);
+                    ++_armed_count;
+                }
+            }
+
+            fired.clear();
+        }
+    }
+
+public:
+    /**
+     * @param resolution Tick duration.
+     * @param dispatch Callback delivery function, by default callback is
+     *        called directly from the wheel thread.
+     */
+    timing_wheel (std::chrono::microseconds resolution = std::chrono::milliseconds{1}
+        , dispatch_type && dispatch = dispatch_type{})
+        : _resolution(resolution.count() > 0 ? resolution : std::chrono::microseconds{1})
+        , _start(clock_type::now())
+        , _dispatch(std::move(dispatch))
+    {
+        if (!_dispatch)
+            _dispatch = [] (void *, callback_type & callback) { callback(); };
+
+        for (auto & level: _slots) {
+            for (auto & head: level)
+                head = nullptr;
+        }
+
+        _thread = std::thread(& timing_wheel::run, this);
+    }
+
+    timing_wheel (timing_wheel const &) = delete;
+    timing_wheel & operator = (timing_wheel const &) = delete;
+    timing_wheel (timing_wheel &&) = delete;
+    timing_wheel & operator = (timing_wheel &&) = delete;
+
+    ~timing_wheel ()
+    {
+        {
+            std::unique_lock<std::mutex> locker(_mtx);
+            _stop = true;
+            _cond.notify_all();
+        }
+
+        if (_thread.joinable())
+            _thread.join();
+    }
+
+    std::chrono::microseconds resolution () const noexcept
+    {
+        return _resolution;
+    }
+
+    /**
+     * Arms timer expired after @a delay and then (if @a period is not zero)
+     * periodically with @a period according to @a mode. Delays are rounded up
+     * to the resolution.
+     *
+     * @return Timer identifier or zero if the entry limit exceeded.
+     */
+    timer_id create (std::chrono::microseconds delay, std::chrono::microseconds period
+        , timer_mode mode, void * target, callback_type && callback)
+    {
+        std::unique_lock<std::mutex> locker(_mtx);
+
+        auto e = acquire_entry();
+
+        if (e == nullptr)
+            return timer_id{0};
+
+        e->period = to_ticks(period);
+        e->mode = mode;
+        e->target = target;
+        e->callback = std::move(callback);
+        arm(e, delay);
+
+        return make_id(e);
+    }
+
+    timer_id create (std::chrono::microseconds delay, std::chrono::microseconds period
+        , void * target, callback_type && callback)
+    {
+        return create(delay, period, timer_mode::fixed_rate, target, std::move(callback));
+    }
+
+    timer_id create (std::chrono::microseconds delay, std::chrono::microseconds period
+        , callback_type && callback)
+    {
+        return create(delay, period, nullptr, std::move(callback));
+    }
+
+    timer_id create (std::chrono::microseconds delay, callback_type && callback)
+    {
+        return create(delay, std::chrono::microseconds{0}, nullptr, std::move(callback));
+    }
+
+    /**
+     * Re-arms the expired fixed-delay timer with its period. If the timer
+     * callback is still being dispatched by the wheel thread, the timer is
+     * re-armed right after the dispatch.
+     *
+     * @return @c false if timer is not an expired fixed-delay timer
+     *         (e.g. destroyed).
+     */
+    bool resume (timer_id id)
+    {
+        std::unique_lock<std::mutex> locker(_mtx);
+
+        auto e = find_entry(id);
+
+        if (e == nullptr)
+            return false;
+
+        if (e->state == entry_state::firing && e->period != 0
+                && e->mode == timer_mode::fixed_delay) {
+            e->resume_requested = true;
+            return true;
+        }
+
+        if (e->state != entry_state::suspended)
+            return false;
+
+        arm(e, e->period * _resolution);
+        return true;
+    }
+
+    void destroy (timer_id id)
+    {
+        std::unique_lock<std::mutex> locker(_mtx);
+
+        auto e = find_entry(id);
+
+        if (e == nullptr)
+            return;
+
+        switch (e->state) {
+            case entry_state::armed:
+                unlink(e);
+                --_armed_count;
+                release_entry(e);
+                break;
+
+            // Released by the wheel thread after callback dispatched
+            case entry_state::firing:
+                e->state = entry_state::cancelled;
+                break;
+
+            case entry_state::suspended:
+                release_entry(e);
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    void destroy_all ()
+    {
+        std::unique_lock<std::mutex> locker(_mtx);
+
+        for (auto & e: _entries) {
+            if (e.state == entry_state::armed) {
+                e.prev = e.next = nullptr;
+                e.slot = nullptr;
+                release_entry(& e);
+            } else if (e.state == entry_state::firing) {
+                e.state = entry_state::cancelled;
+            } else if (e.state == entry_state::suspended) {
+                release_entry(& e);
+            }
+        }
+
+        for (auto & level: _slots) {
+            for (auto & head: level)
+                head = nullptr;
+        }
+
+        _armed_count = 0;
+    }
+
+    /**
+     * Number of wheel thread wakeups (for diagnostics).
+     */
+    std::size_t wakeup_count ()
+    {
+        std::unique_lock<std::mutex> locker(_mtx);
+        return _wakeup_count;
+    }
+
+    /**
+     * Number of armed timers.
+     */
+    std::size_t count ()
+    {
+        std::unique_lock<std::mutex> locker(_mtx);
+        return _armed_count;
+    }
+};
+
+MODULUS__NAMESPACE_END
@@ -0,0 +1,264 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Vladislav Trifochkin
+//
+// License: see LICENSE file
+//
+// This file is part of `modulus2-lib`.
+//
+// Changelog:
+//      2026.10.17 Initial version.
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "namespace.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+MODULUS__NAMESPACE_BEGIN
+
+/**
+ * Fixed size work-stealing thread pool.
+ *
+ * Each worker has own task deque. Tasks posted from a worker thread are
+ * placed into its own deque, other tasks are distributed round-robin.
+ * Idle worker steals tasks from the back of other workers' deques before
+ * parking.
+ */
+class worker_pool
+{
+public:
+    using task_type = std::function<void()>;
+
+private:
+    struct task_deque
+    {
+        std::mutex mtx;
+        std::deque<task_type> tasks;
+    };
+
+    std::vector<std::unique_ptr<task_deque>> _deques;
+    std::vector<std::thread> _threads;
+    std::atomic<std::size_t> _next {0};
+    std::atomic<std::size_t> _pending {0};
+    std::atomic_bool _stop {false};
+
+    std::atomic<int> _parked_count {0};
+    std::mutex _park_mtx;
+    std::condition_variable _park_cond;
+
+private:
+    struct current_worker
+    {
+        worker_pool * pool {nullptr};
+        std::size_t index {0};
+    };
+
+    static current_worker & current ()
+    {
+        static thread_local current_worker w;
+        return w;
+    }
+
+    bool pop_own (std::size_t index, task_type & task)
+    {
+        auto & d = *_deques[index];
+        std::unique_lock<std::mutex> locker(d.mtx);
+
+        if (d.tasks.empty())
+            return false;
+
+        task = std::move(d.tasks.front());
+        d.tasks.pop_front();
+        return true;
+    }
+
+    bool steal (std::size_t index, task_type & task)
+    {
+        auto n = _deques.size();
+
+        for (std::size_t i = 1; i < n; i++) {
+            auto & d = *_deques[(index + i) % n];
+            std::unique_lock<std::mutex> locker(d.mtx);
+
+            if (!d.tasks.empty()) {
+                task = std::move(d.tasks.back());
+                d.tasks.pop_back();
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void worker_main (std::size_t index)
+    {
+        current().pool = this;
+        current().index = index;
+
+        task_type task;
+
+        while (!_stop.load()) {
+            if (pop_own(index, task) || steal(index, task)) {
+                --_pending;
+                task();
+                task = nullptr;
+                continue;
+            }
+
+            std::unique_lock<std::mutex> locker(_park_mtx);
+            ++_parked_count;
+            _park_cond.wait(locker, [this] { return _pending.load() > 0 || _stop.load(); });
+            --_parked_count;
+        }
+
+        current().pool = nullptr;
+    }
+
+public:
+    /**
+     * Starts @a thread_count workers (number of hardware threads if zero).
+     */
+    explicit worker_pool (std::size_t thread_count = 0)
+    {
+        if (thread_count == 0)
+            thread_count = std::thread::hardware_concurrency();
+
+        if (thread_count == 0)
+            thread_count = 1;
+
+        for (std::size_t i = 0; i < thread_count; i++)
+            _deques.emplace_back(new task_deque);
+
+        for (std::size_t i = 0; i < thread_count; i++)
+            _threads.emplace_back(& worker_pool::worker_main, this, i);
+    }
+
+    worker_pool (worker_pool const &) = delete;
+    worker_pool & operator = (worker_pool const &) = delete;
+    worker_pool (worker_pool &&) = delete;
+    worker_pool & operator = (worker_pool &&) = delete;
+
+    ~worker_pool ()
+    {
+        stop();
+    }
+
+    std::size_t size () const noexcept
+    {
+        return _deques.size();
+    }
+
+    void post (task_type && task)
+    {
+        auto & w = current();
+        auto index = w.pool == this
+            ? w.index
+            : _next.fetch_add(1, std::memory_order_relaxed) % _deques.size();
+
+        {
+            auto & d = *_deques[index];
+            std::unique_lock<std::mutex> locker(d.mtx);
+            d.tasks.push_back(std::move(task));
+        }
+
+        ++_pending;
+
+        if (_parked_count.load() > 0) {
+            std::unique_lock<std::mutex> locker(_park_mtx);
+            _park_cond.notify_one();
+        }
+    }
+
+    /**
+     * Stops and joins workers. Tasks not started yet are discarded.
+     */
+    void stop ()
+    {
+        {
+            std::unique_lock<std::mutex> locker(_park_mtx);
+            _stop = true;
+            _park_cond.notify_all();
+        }
+
+        for (auto & th: _threads) {
+            if (th.joinable())
+                th.join();
+        }
+
+        _threads.clear();
+
+        for (auto & d: _deques)
+            d->tasks.clear();
+    }
+};
+
+/**
+ * Serializes processing of the queue on the worker pool: at most one worker
+ * calls queue actions at a time, so the queue consumer remains single-threaded
+ * as for the dedicated thread.
+ */
+template <typename QueueType>
+class strand
+{
+    worker_pool * _pool {nullptr};
+    QueueType * _q {nullptr};
+    int _batch_size {64};
+
+    // Strand is suspended (as if already scheduled) until start() called
+    std::atomic_bool _scheduled {true};
+
+private:
+    void run ()
+    {
+        _q->call(_batch_size);
+        _scheduled.store(false);
+
+        // Actions pushed while calling were not scheduled
+        if (!_q->empty())
+            notify();
+    }
+
+public:
+    /**
+     * @param batch_size Maximum number of actions called per one task, so
+     *        strands sharing the pool are processed fairly.
+     */
+    strand (worker_pool & pool, QueueType & q, int batch_size = 64)
+        : _pool(& pool)
+        , _q(& q)
+        , _batch_size(batch_size)
+    {}
+
+    strand (strand const &) = delete;
+    strand & operator = (strand const &) = delete;
+    strand (strand &&) = delete;
+    strand & operator = (strand &&) = delete;
+
+    /**
+     * Resumes the suspended strand.
+     */
+    void start ()
+    {
+        _scheduled.store(false);
+
+        if (!_q->empty())
+            notify();
+    }
+
+    /**
+     * Schedules the queue processing if it is not scheduled yet.
+     */
+    void notify ()
+    {
+        if (!_scheduled.exchange(true))
+            _pool->post([this] { run(); });
+    }
+};
+
+MODULUS__NAMESPACE_END
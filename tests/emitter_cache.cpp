@@ -0,0 +1,70 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Vladislav Trifochkin
+//
+// License: see LICENSE file
+//
+// This file is part of `modulus2-lib`.
+//
+// Changelog:
+//      2026.10.17 Initial version.
+////////////////////////////////////////////////////////////////////////////////
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "pfs/modulus/emitter_cache.hpp"
+#include <string>
+#include <vector>
+
+enum class api_enum { first = 0, second, third, far_away = 100000 };
+
+template <typename ApiIdType>
+void check_cache (std::vector<ApiIdType> const & ids)
+{
+    std::vector<int> values(ids.size());
+    modulus::emitter_cache<ApiIdType, int> cache;
+
+    for (std::size_t i = 0; i < ids.size(); i++)
+        CHECK(cache.emplace(ids[i], & values[i]));
+
+    // Duplicate is ignored
+    CHECK_FALSE(cache.emplace(ids[0], & values[1]));
+    CHECK_EQ(cache.size(), ids.size());
+
+    for (std::size_t i = 0; i < ids.size(); i++)
+        CHECK_EQ(cache.find(ids[i]), & values[i]);
+
+    // Iteration is ordered by identifier
+    ApiIdType const * prev = nullptr;
+
+    for (auto const & item: cache) {
+        if (prev != nullptr)
+            CHECK(*prev < item.first);
+
+        prev = & item.first;
+    }
+}
+
+TEST_CASE("Dense emitter cache") {
+    static_assert(modulus::api_id_traits<int>::dense, "");
+    static_assert(modulus::api_id_traits<api_enum>::dense, "");
+
+    check_cache<int>({3, 0, 7, -5, 100000});
+    check_cache<api_enum>({api_enum::third, api_enum::first, api_enum::far_away});
+
+    modulus::emitter_cache<int, int> cache;
+    int value = 0;
+    cache.emplace(5, & value);
+
+    CHECK_EQ(cache.find(4), nullptr);
+    CHECK_EQ(cache.find(6), nullptr);
+    CHECK_EQ(cache.find(-1), nullptr);
+    CHECK_EQ(cache.find(1000000), nullptr);
+}
+
+TEST_CASE("Sorted emitter cache") {
+    static_assert(!modulus::api_id_traits<std::string>::dense, "");
+
+    check_cache<std::string>({"b", "a", "c"});
+
+    modulus::emitter_cache<std::string, int> cache;
+    CHECK_EQ(cache.find("a"), nullptr);
+}
@@ -0,0 +1,574 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Vladislav Trifochkin
+//
+// License: see LICENSE file
+//
+// This file is part of `modulus2-lib`.
+//
+// Changelog:
+//      2026.10.17 Initial version.
+//      2026.10.17 Added consumer thread test.
+//      2026.10.17 Added deadline test.
+//      2026.10.17 Added priority lanes test.
+//      2026.10.17 Added subqueues test.
+//      2026.10.17 Added time-budgeted draining test.
+//      2026.10.17 Added wait strategy test.
+//      2026.10.17 Added drop_oldest eviction test.
+//      2026.10.17 Added saturated high lane test.
+//      2026.10.17 Added wakeup actions buildup test.
+////////////////////////////////////////////////////////////////////////////////
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "pfs/modulus/modulus.hpp"
+#include "pfs/modulus/iostream_logger.hpp"
+#include "pfs/modulus/module_queue.hpp"
+#include "pfs/modulus/mpsc_function_queue.hpp"
+#include <pfs/function_queue.hpp>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+template <typename QueueType>
+void check_overflow_policies ()
+{
+    std::vector<int> called;
+    auto f = [& called] (int i) { called.push_back(i); };
+
+    SUBCASE("unlimited") {
+        modulus::module_queue<QueueType> q;
+
+        for (int i = 0; i < 100; i++)
+            CHECK(q.push(f, i));
+
+        CHECK_EQ(q.count(), 100);
+        CHECK_EQ(q.high_water_mark(), 100);
+        CHECK_EQ(q.call_all(), 100);
+        CHECK(q.empty());
+        CHECK_EQ(q.high_water_mark(), 100);
+    }
+
+    SUBCASE("drop_newest") {
+        modulus::module_queue<QueueType> q;
+        q.set_options(modulus::queue_options{3, modulus::overflow_policy::drop_newest});
+
+        for (int i = 0; i < 5; i++)
+            CHECK(q.push(f, i));
+
+        CHECK_EQ(q.count(), 3);
+        CHECK_EQ(q.dropped_count(), 2);
+        q.call_all();
+        CHECK_EQ(called, std::vector<int>{0, 1, 2});
+    }
+
+    SUBCASE("drop_oldest") {
+        modulus::module_queue<QueueType> q;
+        q.set_options(modulus::queue_options{3, modulus::overflow_policy::drop_oldest});
+
+        for (int i = 0; i < 5; i++)
+            CHECK(q.push(f, i));
+
+        CHECK_EQ(q.count(), 3);
+        CHECK_EQ(q.dropped_count(), 2);
+        q.call_all();
+        CHECK_EQ(called, std::vector<int>{2, 3, 4});
+        CHECK(q.empty());
+    }
+
+    SUBCASE("fail") {
+        modulus::module_queue<QueueType> q;
+        q.set_options(modulus::queue_options{3, modulus::overflow_policy::fail});
+
+        for (int i = 0; i < 3; i++)
+            CHECK(q.push(f, i));
+
+        CHECK_FALSE(q.push(f, 3));
+        CHECK_EQ(q.rejected_count(), 1);
+        q.call_all();
+        CHECK(q.push(f, 4));
+        q.call_all();
+        CHECK_EQ(called, std::vector<int>{0, 1, 2, 4});
+    }
+
+    SUBCASE("block") {
+        modulus::module_queue<QueueType> q;
+        q.set_options(modulus::queue_options{2, modulus::overflow_policy::block});
+        std::atomic_int pushed {0};
+
+        std::thread producer {[&] {
+            for (int i = 0; i < 10; i++) {
+                q.push(f, i);
+                ++pushed;
+            }
+        }};
+
+        while (called.size() < 10) {
+            q.wait_for(1000);
+            CHECK_LE(q.count(), 2);
+            q.call(1);
+        }
+
+        producer.join();
+
+        CHECK_EQ(pushed.load(), 10);
+        CHECK_EQ(q.high_water_mark(), 2);
+        CHECK_EQ(called, std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9});
+    }
+}
+
+TEST_CASE("module_queue overflow policies with pfs::function_queue") {
+    check_overflow_policies<pfs::function_queue<>>();
+}
+
+TEST_CASE("module_queue overflow policies with mpsc_function_queue") {
+    check_overflow_policies<modulus::mpsc_function_queue>();
+}
+
+TEST_CASE("module_queue drop_oldest evicts at push time") {
+    modulus::module_queue<pfs::function_queue<>> q;
+    q.set_options(modulus::queue_options{4, modulus::overflow_policy::drop_oldest});
+
+    std::vector<int> called;
+    std::vector<std::weak_ptr<int>> tokens;
+
+    auto push = [& q, & called, & tokens] (modulus::queue_priority priority, int i) {
+        auto token = std::make_shared<int>(i);
+        tokens.push_back(token);
+        return q.push_priority(priority, [& called, token] { called.push_back(*token); });
+    };
+
+    // Slow consumer: nothing is called while pushing
+    for (int i = 0; i < 100; i++) {
+        CHECK(push(modulus::queue_priority::normal, i));
+        CHECK_LE(q.count(), 4);
+    }
+
+    CHECK_EQ(q.count(), 4);
+    CHECK_EQ(q.high_water_mark(), 4);
+    CHECK_EQ(q.dropped_count(), 96);
+
+    // Evicted actions are destroyed at push time
+    for (int i = 0; i < 100; i++)
+        CHECK_EQ(tokens[i].expired(), i < 96);
+
+    // Higher priority action evicts the oldest normal one, lower priority
+    // action can't evict any
+    CHECK(push(modulus::queue_priority::high, 100));
+    CHECK(tokens[96].expired());
+    CHECK(push(modulus::queue_priority::low, 101));
+    CHECK(tokens[101].expired());
+    CHECK_EQ(q.dropped_count(), 98);
+
+    // Lower priority actions are evicted first
+    CHECK(push(modulus::queue_priority::high, 102));
+    CHECK(push(modulus::queue_priority::high, 103));
+    CHECK(push(modulus::queue_priority::high, 104));
+    CHECK(tokens[99].expired());
+    CHECK_FALSE(tokens[100].expired());
+
+    // The oldest high priority action is evicted when there are no others
+    CHECK(push(modulus::queue_priority::high, 105));
+    CHECK(tokens[100].expired());
+    CHECK_EQ(q.dropped_count(), 102);
+
+    CHECK_EQ(q.count(), 4);
+    CHECK_EQ(q.call_all(), 8); // Including trampolines of evicted actions
+    CHECK(called == std::vector<int>{102, 103, 104, 105});
+    CHECK(q.empty());
+
+    // Queue is reusable after draining
+    called.clear();
+    CHECK(push(modulus::queue_priority::normal, 200));
+    CHECK_EQ(q.call_all(), 1);
+    CHECK(called == std::vector<int>{200});
+}
+
+TEST_CASE("module_queue wakeup is not limited by capacity") {
+    modulus::module_queue<pfs::function_queue<>> q;
+    q.set_options(modulus::queue_options{1, modulus::overflow_policy::fail});
+
+    CHECK(q.push([] {}));
+    q.wakeup();
+    q.wakeup();
+
+    CHECK_EQ(q.count(), 1);
+    CHECK_EQ(q.rejected_count(), 0);
+}
+
+TEST_CASE("module_queue consumer thread") {
+    modulus::module_queue<pfs::function_queue<>> q;
+    std::vector<bool> inside;
+
+    CHECK_FALSE(q.is_consumer_thread());
+
+    q.push([& q, & inside] {
+        inside.push_back(q.is_consumer_thread());
+        inside.push_back(q.can_call_inline());
+
+        // Pending action disables inline call
+        q.push([] {});
+        inside.push_back(q.can_call_inline());
+    });
+
+    q.call_all();
+
+    CHECK(inside == std::vector<bool>{true, true, false});
+    CHECK_FALSE(q.is_consumer_thread());
+
+    q.set_owner(std::this_thread::get_id());
+    CHECK(q.is_consumer_thread());
+    CHECK(q.can_call_inline());
+
+    bool other_thread_consumer = true;
+    std::thread t {[& q, & other_thread_consumer] {
+        other_thread_consumer = q.is_consumer_thread();
+    }};
+    t.join();
+
+    CHECK_FALSE(other_thread_consumer);
+
+    q.set_owner(std::thread::id{});
+    CHECK_FALSE(q.is_consumer_thread());
+}
+
+TEST_CASE("module_queue deadlines") {
+    modulus::module_queue<pfs::function_queue<>> q;
+    std::vector<int> called;
+    auto f = [& called] (int i) { called.push_back(i); };
+    auto now = modulus::deadline_clock::now();
+
+    // Expired before push
+    CHECK(q.push_until(now - std::chrono::milliseconds{1}, f, 1));
+    CHECK_EQ(q.count(), 0);
+    CHECK_EQ(q.expired_count(), 1);
+
+    // Expired while queued
+    CHECK(q.push_until(now + std::chrono::milliseconds{5}, f, 2));
+    CHECK(q.push_until(now + std::chrono::seconds{10}, f, 3));
+    CHECK(q.push(f, 4));
+
+    {
+        // Deadline of the scope is applied by emitter connections
+        modulus::deadline_scope scope {std::chrono::milliseconds{5}};
+
+        CHECK(q.push_discardable_until(modulus::queue_priority::normal
+            , modulus::deadline_scope::current_deadline(), nullptr, f, 5));
+
+        // Ordinary push is not limited
+        CHECK(q.push(f, 6));
+
+        // Nested scope can't extend deadline
+        modulus::deadline_scope nested {std::chrono::seconds{10}};
+        CHECK(q.push_discardable_until(modulus::queue_priority::normal
+            , modulus::deadline_scope::current_deadline(), nullptr, f, 7));
+
+        // But can lift it
+        modulus::deadline_scope lifted {modulus::deadline_scope::none{}};
+        CHECK(modulus::deadline_scope::current_deadline() == modulus::deadline_clock::time_point::max());
+    }
+
+    CHECK(modulus::deadline_scope::current_deadline() == modulus::deadline_clock::time_point::max());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{10});
+
+    CHECK_EQ(q.call_all(), 6);
+    CHECK(called == std::vector<int>{3, 4, 6});
+    CHECK_EQ(q.expired_count(), 4);
+    CHECK(q.empty());
+}
+
+TEST_CASE("module_queue priority lanes") {
+    modulus::module_queue<pfs::function_queue<>> q;
+    std::vector<int> called;
+    auto f = [& called] (int i) { called.push_back(i); };
+
+    CHECK(q.push_priority(modulus::queue_priority::low, f, 1));
+    CHECK(q.push(f, 2));
+    CHECK(q.push(f, 3));
+
+    {
+        modulus::priority_scope scope {modulus::queue_priority::high};
+        CHECK(q.push(f, 4));
+    }
+
+    CHECK(modulus::priority_scope::current_priority() == modulus::queue_priority::normal);
+    CHECK_EQ(q.count(), 4);
+    CHECK_EQ(q.call_all(), 4);
+    CHECK(called == std::vector<int>{4, 2, 3, 1});
+    CHECK(q.empty());
+
+    // Low priority lane is not starved by the normal one
+    auto opts = q.options();
+    opts.starvation_limit = 2;
+    q.set_options(opts);
+    CHECK_EQ(q.options().starvation_limit, 2);
+
+    called.clear();
+
+    for (int i = 0; i < 5; i++)
+        CHECK(q.push(f, i));
+
+    CHECK(q.push_priority(modulus::queue_priority::low, f, 10));
+    CHECK_EQ(q.call_all(), 6);
+    CHECK(called == std::vector<int>{0, 1, 10, 2, 3, 4});
+
+    // Low priority lane is not starved by the saturated high lane while
+    // the normal one has pending actions too
+    called.clear();
+
+    for (int i = 0; i < 20; i++)
+        CHECK(q.push_priority(modulus::queue_priority::high, f, 100 + i));
+
+    for (int i = 0; i < 3; i++) {
+        CHECK(q.push(f, i));
+        CHECK(q.push_priority(modulus::queue_priority::low, f, 10 + i));
+    }
+
+    CHECK_EQ(q.call_all(), 26);
+
+    std::vector<int> expected;
+
+    for (int i = 0; i < 3; i++)
+        expected.insert(expected.end(), {100 + 2 * i, 101 + 2 * i, 10 + i, i});
+
+    for (int i = 106; i < 120; i++)
+        expected.push_back(i);
+
+    CHECK(called == expected);
+
+    // Action pushed to the high lane wakes up consumer waiting on queue
+    std::thread producer {[& q, & f] {
+        std::this_thread::sleep_for(std::chrono::milliseconds{5});
+        q.push_priority(modulus::queue_priority::high, f, 20);
+    }};
+
+    q.wait();
+    producer.join();
+
+    CHECK_EQ(q.call(), 1);
+    CHECK_EQ(called.back(), 20);
+    CHECK(q.empty());
+}
+
+// Function queue tracking the maximum number of pending actions (including
+// wakeup actions not counted by module_queue)
+class counting_function_queue
+{
+    pfs::function_queue<> _q;
+    std::atomic<std::size_t> _size {0};
+
+public:
+    static std::atomic<std::size_t> max_size;
+
+public:
+    template <typename F, typename ...Args>
+    void push (F && f, Args &&... args)
+    {
+        auto size = ++_size;
+        auto max = max_size.load();
+
+        while (size > max && !max_size.compare_exchange_weak(max, size))
+            ;
+
+        _q.push(std::forward<F>(f), std::forward<Args>(args)...);
+    }
+
+    bool empty () const { return _q.empty(); }
+
+    std::size_t call () { return call(1); }
+
+    std::size_t call (int max_count)
+    {
+        auto n = _q.call(max_count);
+        _size -= n;
+        return n;
+    }
+
+    std::size_t call_all ()
+    {
+        auto n = _q.call_all();
+        _size -= n;
+        return n;
+    }
+
+    void wait () { _q.wait(); }
+    bool wait_for (intmax_t microseconds) { return _q.wait_for(microseconds); }
+};
+
+std::atomic<std::size_t> counting_function_queue::max_size {0};
+
+TEST_CASE("module_queue wakeup actions do not pile up") {
+    modulus::module_queue<counting_function_queue> q;
+    modulus::queue_options opts;
+    opts.capacity = 16;
+    opts.overflow = modulus::overflow_policy::fail;
+    q.set_options(opts);
+
+    int called = 0;
+    auto f = [& called] { ++called; };
+
+    for (int i = 0; i < 16; i++)
+        CHECK(q.push_priority(modulus::queue_priority::high, f));
+
+    // Saturated high lane while the normal lane is empty: each push needs
+    // the consumer waiting on the normal lane to be woken up
+    for (int i = 0; i < 10000; i++) {
+        CHECK_EQ(q.call(), 1);
+        CHECK(q.push_priority(modulus::queue_priority::high, f));
+    }
+
+    CHECK_LE(counting_function_queue::max_size.load(), 32);
+
+    CHECK_EQ(q.call_all(), 16);
+    CHECK_EQ(called, 10016);
+    CHECK(q.empty());
+}
+
+TEST_CASE("module_queue subqueues") {
+    using queue_type = modulus::module_queue<pfs::function_queue<>>;
+    queue_type parent;
+    queue_type chatty;
+    queue_type quiet;
+    std::vector<std::string> called;
+    auto f = [& called] (std::string s) { called.push_back(std::move(s)); };
+
+    auto opts = quiet.options();
+    opts.weight = 2;
+    quiet.set_options(opts);
+
+    parent.attach_subqueue(chatty);
+    parent.attach_subqueue(quiet);
+
+    for (int i = 0; i < 6; i++)
+        CHECK(chatty.push(f, "a" + std::to_string(i)));
+
+    for (int i = 0; i < 4; i++)
+        CHECK(quiet.push(f, "b" + std::to_string(i)));
+
+    CHECK_EQ(chatty.count(), 6);
+    CHECK_EQ(quiet.count(), 4);
+    CHECK_EQ(parent.count(), 0);
+    CHECK_FALSE(parent.empty());
+
+    // Does not block while subqueues have pending actions
+    parent.wait();
+
+    CHECK_EQ(parent.call_all(), 10);
+    CHECK(called == std::vector<std::string>{"a0", "b0", "b1", "a1", "b2", "b3"
+        , "a2", "a3", "a4", "a5"});
+    CHECK(parent.empty());
+
+    // Push into subqueue wakes up consumer of the parent queue
+    std::thread producer {[& quiet, & f] {
+        std::this_thread::sleep_for(std::chrono::milliseconds{5});
+        quiet.push(f, "c");
+    }};
+
+    parent.wait();
+    producer.join();
+
+    CHECK_EQ(parent.call_all(), 1);
+    CHECK_EQ(called.back(), "c");
+
+    parent.detach_subqueue(chatty);
+    parent.detach_subqueue(quiet);
+
+    CHECK(chatty.push(f, "d"));
+    CHECK(parent.empty());
+    CHECK_EQ(chatty.call_all(), 1);
+}
+
+TEST_CASE("module_queue time-budgeted draining") {
+    modulus::module_queue<pfs::function_queue<>> q;
+    int called = 0;
+    auto f = [& called] {
+        std::this_thread::sleep_for(std::chrono::milliseconds{2});
+        ++called;
+    };
+
+    for (int i = 0; i < 10; i++)
+        CHECK(q.push(f));
+
+    auto n = q.call_for(5000);
+
+    CHECK_GE(n, 1);
+    CHECK_LT(n, 10);
+    CHECK_EQ(called, n);
+    CHECK_EQ(q.count(), 10 - n);
+
+    CHECK_EQ(q.call_for(1000000), 10 - n);
+    CHECK(q.empty());
+    CHECK_EQ(q.call_for(1000), 0);
+}
+
+TEST_CASE("module_queue wait strategy") {
+    modulus::module_queue<pfs::function_queue<>> q;
+
+    auto opts = q.options();
+    opts.spin_time = std::chrono::milliseconds{20};
+    opts.yield_time = std::chrono::milliseconds{20};
+    q.set_options(opts);
+
+    CHECK(q.options().spin_time == std::chrono::milliseconds{20});
+    CHECK(q.options().yield_time == std::chrono::milliseconds{20});
+
+    // Times out while spinning and yielding
+    auto start = std::chrono::steady_clock::now();
+    CHECK_FALSE(q.wait_for(10000));
+    CHECK(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds{10});
+
+    // Action pushed while spinning, yielding and parked
+    for (auto delay: {1, 30, 60}) {
+        std::atomic<bool> called {false};
+
+        std::thread producer {[& q, & called, delay] {
+            std::this_thread::sleep_for(std::chrono::milliseconds{delay});
+            q.push([& called] { called = true; });
+        }};
+
+        q.wait();
+        producer.join();
+
+        CHECK_EQ(q.call_all(), 1);
+        CHECK(called);
+    }
+
+    // Wakeup is not counted as pending action
+    std::thread waker {[& q] {
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        q.wakeup();
+    }};
+
+    q.wait();
+    waker.join();
+    CHECK(q.empty());
+    CHECK_EQ(q.call_all(), 0);
+}
+
+using modulus_t = modulus::modulus<modulus::iostream_logger, modulus::null_settings>;
+
+class bounded_runnable : public modulus_t::runnable_module
+{};
+
+TEST_CASE("module queue options") {
+    modulus_t::dispatcher d{std::make_shared<modulus::iostream_logger>(), modulus::null_settings{}};
+
+    CHECK(d.register_module<bounded_runnable>(std::make_pair("r", "")));
+
+    modulus::module_options opts;
+    opts.queue.capacity = 16;
+    opts.queue.overflow = modulus::overflow_policy::drop_oldest;
+
+    CHECK(d.set_module_options("r", opts));
+    CHECK_FALSE(d.set_module_options("unknown", opts));
+
+    auto q = d.queue_for("r");
+    REQUIRE(q != nullptr);
+    CHECK_EQ(q->options().capacity, 16);
+    CHECK(q->options().overflow == modulus::overflow_policy::drop_oldest);
+    CHECK_EQ(q->high_water_mark(), 0);
+
+    CHECK(d.queue_for("") != nullptr);
+    CHECK(d.queue_for("unknown") == nullptr);
+}
@@ -13,6 +13,20 @@
 #include "pfs/modulus/modulus.hpp"
 #include "pfs/modulus/iostream_logger.hpp"
 #include "pfs/modulus/plugins/timer_quit.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if __linux__
+#   include <sys/mman.h>
+#   include <unistd.h>
+#endif
 
 using modulus_t = modulus::modulus<modulus::iostream_logger, modulus::null_settings>;
 
@@ -534,3 +548,2138 @@ TEST_CASE("Modulus basics") {
     CHECK(d.exec() == exit_status::success);
     CHECK_EQ(__timer_counter, 6);
 }
+
+class idle_runnable : public modulus_t::runnable_module
+{};
+
+class quit_by_timer : public modulus_t::regular_module
+{
+private:
+    bool on_start () override
+    {
+        start_timer(std::chrono::milliseconds(50), [this] {
+            quit();
+        });
+
+        return true;
+    }
+};
+
+class chatty_regular : public modulus_t::regular_module
+{
+private:
+    bool on_start () override
+    {
+        // Pushed into the dispatcher's queue before it is processed
+        for (int i = 0; i < 10; i++)
+            log_debug("message " + std::to_string(i));
+
+        start_timer(std::chrono::milliseconds(1), [this] {
+            for (int i = 0; i < 10; i++)
+                log_debug("timer message " + std::to_string(i));
+
+            start_timer(std::chrono::milliseconds(1), [this] { quit(); });
+        });
+
+        return true;
+    }
+};
+
+TEST_CASE("Dispatcher queue capacity") {
+    using exit_status = modulus_t::exit_status;
+
+    for (auto overflow: {modulus::overflow_policy::block, modulus::overflow_policy::drop_newest
+            , modulus::overflow_policy::fail}) {
+        modulus_t::dispatcher d{std::make_shared<modulus::iostream_logger>(), modulus::null_settings{}};
+        modulus::timer_quit_plugin timer_quit_plugin {5};
+
+        modulus::queue_options opts;
+        opts.capacity = 1;
+        opts.overflow = overflow;
+        d.set_queue_options(opts);
+
+        CHECK(d.register_module<chatty_regular>(std::make_pair("chatty", "")));
+
+        // Log records and timer callbacks neither deadlock the dispatcher
+        // nor get lost
+        d.attach_plugin(timer_quit_plugin);
+        CHECK(d.exec() == exit_status::success);
+        timer_quit_plugin.stop();
+
+        CHECK_FALSE(timer_quit_plugin.timedout());
+    }
+}
+
+TEST_CASE("Quit latency") {
+    using exit_status = modulus_t::exit_status;
+    modulus_t::dispatcher d{std::make_shared<modulus::iostream_logger>(), modulus::null_settings{}};
+
+    CHECK(d.register_module<idle_runnable>(std::make_pair("r1", "")));
+    CHECK(d.register_module<idle_runnable>(std::make_pair("r2", "")));
+    CHECK(d.register_module<quit_by_timer>(std::make_pair("q", "")));
+
+    auto start = std::chrono::steady_clock::now();
+    CHECK(d.exec() == exit_status::success);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    // Previously dispatcher and runnable modules polled their queues every
+    // 500 ms, so quit took up to half a second per thread.
+    CHECK_LT(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count(), 400);
+}
+
+TEST_CASE("Timing wheel timer backend") {
+    using exit_status = modulus_t::exit_status;
+    modulus_t::dispatcher d{std::make_shared<modulus::iostream_logger>(), modulus::null_settings{}};
+
+    d.set_timer_backend(modulus::timer_backend::timing_wheel);
+
+    CHECK(d.register_module<idle_runnable>(std::make_pair("r1", "")));
+    CHECK(d.register_module<quit_by_timer>(std::make_pair("q", "")));
+
+    auto start = std::chrono::steady_clock::now();
+    CHECK(d.exec() == exit_status::success);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    CHECK_GE(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count(), 50);
+    CHECK_LT(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count(), 400);
+}
+
+static std::size_t __overrun_ticks = 0;
+static std::size_t __overrun_missed = 0;
+static std::vector<std::chrono::steady_clock::time_point> __overrun_calls;
+
+class overrun_timer : public modulus_t::regular_module
+{
+private:
+    bool on_start () override
+    {
+        start_periodic_timer(std::chrono::microseconds(2000), [this] (std::size_t missed) {
+            // Rest of catch-up burst after quit()
+            if (__overrun_ticks == 5)
+                return;
+
+            __overrun_missed += missed;
+            __overrun_calls.push_back(std::chrono::steady_clock::now());
+
+            // Overrun the period
+            if (++__overrun_ticks == 1)
+                std::this_thread::sleep_for(std::chrono::milliseconds(15));
+
+            if (__overrun_ticks == 5)
+                quit();
+        });
+
+        return true;
+    }
+};
+
+static std::vector<std::chrono::steady_clock::time_point> __fixed_delay_calls;
+static std::size_t __fixed_delay_missed = 0;
+
+class fixed_delay_timer : public modulus_t::regular_module
+{
+private:
+    bool on_start () override
+    {
+        start_periodic_timer(std::chrono::milliseconds(5), [this] (std::size_t missed) {
+            __fixed_delay_missed += missed;
+            __fixed_delay_calls.push_back(std::chrono::steady_clock::now());
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+            if (__fixed_delay_calls.size() == 4)
+                quit();
+        }, modulus::timer_mode::fixed_delay);
+
+        return true;
+    }
+};
+
+static std::size_t __fast_fixed_delay_ticks = 0;
+
+class fast_fixed_delay_timer : public modulus_t::regular_module
+{
+private:
+    bool on_start () override
+    {
+        // Callback returns immediately, so the timer is resumed while the
+        // tick may still be dispatched by the timer thread
+        start_periodic_timer(std::chrono::milliseconds(1), [] (std::size_t) {
+            ++__fast_fixed_delay_ticks;
+        }, modulus::timer_mode::fixed_delay);
+
+        start_timer(std::chrono::milliseconds(300), [this] { quit(); });
+        return true;
+    }
+};
+
+TEST_CASE("Periodic timer modes") {
+    using exit_status = modulus_t::exit_status;
+
+    for (auto backend: {modulus::timer_backend::timer_pool, modulus::timer_backend::timing_wheel}) {
+        __overrun_ticks = 0;
+        __overrun_missed = 0;
+        __overrun_calls.clear();
+
+        {
+            modulus_t::dispatcher d{std::make_shared<modulus::iostream_logger>(), modulus::null_settings{}};
+            d.set_timer_backend(backend);
+            CHECK(d.register_module<overrun_timer>(std::make_pair("overrun", "")));
+            CHECK(d.exec() == exit_status::success);
+        }
+
+        REQUIRE_EQ(__overrun_calls.size(), 5);
+
+        // Overdue ticks of 15 ms overrun of the 2 ms period are called in
+        // burst (the schedule would spread them over 6 ms)
+        CHECK(__overrun_calls[4] - __overrun_calls[1] < std::chrono::milliseconds(3));
+
+        __overrun_ticks = 0;
+        __overrun_missed = 0;
+        __overrun_calls.clear();
+
+        {
+            modulus_t::dispatcher d{std::make_shared<modulus::iostream_logger>(), modulus::null_settings{}};
+            d.set_timer_backend(backend);
+            d.set_timer_catch_up_limit(0);
+            CHECK(d.register_module<overrun_timer>(std::make_pair("overrun", "")));
+            CHECK(d.exec() == exit_status::success);
+        }
+
+        CHECK_EQ(__overrun_ticks, 5);
+
+        // Overdue ticks are coalesced
+        CHECK_GE(__overrun_missed, 5);
+
+        __fixed_delay_calls.clear();
+        __fixed_delay_missed = 0;
+
+        {
+            modulus_t::dispatcher d{std::make_shared<modulus::iostream_logger>(), modulus::null_settings{}};
+            d.set_timer_backend(backend);
+            CHECK(d.register_module<fixed_delay_timer>(std::make_pair("fixed_delay", "")));
+            CHECK(d.exec() == exit_status::success);
+        }
+
+        REQUIRE_EQ(__fixed_delay_calls.size(), 4);
+        CHECK_EQ(__fixed_delay_missed, 0);
+
+        // Delay is counted from the end of the previous call
+        for (std::size_t i = 1; i < __fixed_delay_calls.size(); i++)
+            CHECK(__fixed_delay_calls[i] - __fixed_delay_calls[i - 1] >= std::chrono::milliseconds(10));
+
+        __fast_fixed_delay_ticks = 0;
+
+        {
+            modulus_t::dispatcher d{std::make_shared<modulus::iostream_logger>(), modulus::null_settings{}};
+            d.set_timer_backend(backend);
+            CHECK(d.register_module<fast_fixed_delay_timer>(std::make_pair("fast_fixed_delay", "")));
+            CHECK(d.exec() == exit_status::success);
+        }
+
+        // Timer is never lost, ticks are delivered during whole 300 ms
+        // (1-2 ms per tick)
+        MESSAGE("fixed-delay ticks: " << __fast_fixed_delay_ticks);
+        CHECK_GE(__fast_fixed_delay_ticks, 100);
+    }
+}
+
+static int __declared_sum = 0;
+static int __declared_connect_calls = 0;
+static int __legacy_sum = 0;
+
+class indexed_producer : public modulus_t::regular_module
+{
+    modulus_t::emitter_type<int> emitA;
+    modulus_t::emitter_type<int> emitB;
+
+private:
+    void declare_emitters (modulus_t::module_context & ctx) override
+    {
+        ctx.declare_emitter(100, emitA);
+        ctx.declare_emitter(101, emitB);
+    }
+
+    bool on_start () override
+    {
+        emitA(1);
+        emitB(10);
+        return true;
+    }
+};
+
+class declared_consumer : public modulus_t::regular_module
+{
+private:
+    void declare_detectors (modulus_t::module_context & ctx) override
+    {
+        ctx.declare_detector(100);
+    }
+
+    bool connect_detector (modulus_t::api_id_type id
+        , modulus_t::module_context & ctx) override
+    {
+        ++__declared_connect_calls;
+
+        switch (id) {
+            case 100:
+                return ctx.connect_detector(id, *this, & declared_consumer::onA);
+        }
+
+        return false;
+    }
+
+    void onA (int value)
+    {
+        __declared_sum += value;
+    }
+};
+
+class legacy_consumer : public modulus_t::regular_module
+{
+private:
+    bool connect_detector (modulus_t::api_id_type id
+        , modulus_t::module_context & ctx) override
+    {
+        switch (id) {
+            case 100:
+                return ctx.connect_detector(id, *this, & legacy_consumer::onValue);
+            case 101:
+                return ctx.connect_detector(id, *this, & legacy_consumer::onValue);
+        }
+
+        return false;
+    }
+
+    void onValue (int value)
+    {
+        __legacy_sum += value;
+    }
+};
+
+TEST_CASE("Declared detectors") {
+    using exit_status = modulus_t::exit_status;
+    modulus_t::dispatcher d{std::make_shared<modulus::iostream_logger>(), modulus::null_settings{}};
+
+    // Consumers registered before and after the producer
+    CHECK(d.register_module<declared_consumer>(std::make_pair("c1", "")));
+    CHECK(d.register_module<legacy_consumer>(std::make_pair("l1", "")));
+    CHECK(d.register_module<indexed_producer>(std::make_pair("p", "")));
+    CHECK(d.register_module<declared_consumer>(std::make_pair("c2", "")));
+    CHECK(d.register_module<legacy_consumer>(std::make_pair("l2", "")));
+    CHECK(d.register_module<quit_by_timer>(std::make_pair("q", "")));
+
+    // Connection attempted for declared API identifier only
+    CHECK_EQ(__declared_connect_calls, 2);
+
+    CHECK(d.exec() == exit_status::success);
+
+    CHECK_EQ(__declared_sum, 2);
+    CHECK_EQ(__legacy_sum, 22);
+}
+
+TEST_CASE("Batch registration") {
+    using exit_status = modulus_t::exit_status;
+    modulus_t::dispatcher d{std::make_shared<modulus::iostream_logger>(), modulus::null_settings{}};
+
+    __declared_sum = 0;
+    __declared_connect_calls = 0;
+    __legacy_sum = 0;
+
+    CHECK(d.register_module<legacy_consumer>(std::make_pair("l1", "")));
+
+    d.begin_batch();
+    CHECK(d.register_module<declared_consumer>(std::make_pair("c1", "")));
+    CHECK(d.register_module<indexed_producer>(std::make_pair("p", "")));
+    CHECK(d.register_module<declared_consumer>(std::make_pair("c2", "")));
+    CHECK(d.register_module<legacy_consumer>(std::make_pair("l2", "")));
+
+    // Wiring is deferred
+    CHECK_EQ(__declared_connect_calls, 0);
+
+    CHECK_EQ(d.commit_batch(), 6);
+    CHECK_EQ(__declared_connect_calls, 2);
+
+    // Wired by exec()
+    d.begin_batch();
+    CHECK(d.register_module<declared_consumer>(std::make_pair("c3", "")));
+    CHECK(d.register_module<quit_by_timer>(std::make_pair("q", "")));
+
+    CHECK(d.exec() == exit_status::success);
+
+    CHECK_EQ(__declared_connect_calls, 3);
+    CHECK_EQ(__declared_sum, 3);
+    CHECK_EQ(__legacy_sum, 22);
+}
+
+struct big_message
+{
+    static std::atomic_int copies;
+
+    std::vector<int> data;
+
+    big_message (std::size_t n): data(n, 42) {}
+    big_message (big_message && other) = default;
+    big_message (big_message const & other): data(other.data) { ++copies; }
+};
+
+std::atomic_int big_message::copies {0};
+
+static std::mutex __payload_mtx;
+static std::set<void const *> __payload_addresses;
+static int __payload_received = 0;
+
+class payload_producer : public modulus_t::regular_module
+{
+    modulus_t::payload_emitter<big_message> emitMessage;
+
+private:
+    void declare_emitters (modulus_t::module_context & ctx) override
+    {
+        ctx.declare_emitter(0, emitMessage);
+    }
+
+    bool on_start () override
+    {
+        emitMessage(big_message{16 * 1024});
+        return true;
+    }
+};
+
+template <typename BaseModule>
+class payload_consumer : public BaseModule
+{
+private:
+    void declare_detectors (modulus_t::module_context & ctx) override
+    {
+        ctx.declare_detector(0);
+    }
+
+    bool connect_detector (modulus_t::api_id_type id
+        , modulus_t::module_context & ctx) override
+    {
+        return id == 0 && ctx.connect_detector(id, *this, & payload_consumer::onMessage);
+    }
+
+    void onMessage (modulus::payload<big_message> msg)
+    {
+        std::lock_guard<std::mutex> locker(__payload_mtx);
+        __payload_addresses.insert(msg->data.data());
+        ++__payload_received;
+    }
+};
+
+TEST_CASE("Shared payload") {
+    using exit_status = modulus_t::exit_status;
+    modulus_t::dispatcher d{std::make_shared<modulus::iostream_logger>(), modulus::null_settings{}};
+
+    CHECK(d.register_module<payload_consumer<modulus_t::runnable_module>>(std::make_pair("r1", "")));
+    CHECK(d.register_module<payload_consumer<modulus_t::runnable_module>>(std::make_pair("r2", "")));
+    CHECK(d.register_module<payload_consumer<modulus_t::guest_module>>(std::make_pair("g1", "r1")));
+    CHECK(d.register_module<payload_consumer<modulus_t::regular_module>>(std::make_pair("c1", "")));
+    CHECK(d.register_module<payload_producer>(std::make_pair("p", "")));
+    CHECK(d.register_module<quit_by_timer>(std::make_pair("q", "")));
+
+    CHECK(d.exec() == exit_status::success);
+
+    CHECK_EQ(__payload_received, 4);
+    CHECK_EQ(__payload_addresses.size(), 1);
+    CHECK_EQ(big_message::copies.load(), 0);
+}
+
+static constexpr int FANOUT_COUNT = 16;
+static std::mutex __fanout_mtx;
+static std::map<std::string, std::vector<int>> __fanout_received;
+static std::map<std::string, std::size_t> __fanout_high_water_marks;
+
+class fanout_producer : public modulus_t::regular_module
+{
+    modulus_t::emitter_type<int> emitValue;
+
+private:
+    void declare_emitters (modulus_t::module_context & ctx) override
+    {
+        ctx.declare_emitter(0, emitValue);
+    }
+
+    bool on_start () override
+    {
+        for (int i = 0; i < FANOUT_COUNT; i++)
+            emitValue(i);
+
+        return true;
+    }
+};
+
+template <typename BaseModule>
+class fanout_consumer : public BaseModule
+{
+private:
+    void declare_detectors (modulus_t::module_context & ctx) override
+    {
+        ctx.declare_detector(0);
+    }
+
+    bool connect_detector (modulus_t::api_id_type id
+        , modulus_t::module_context & ctx) override
+    {
+        return id == 0 && ctx.connect_detector(id, *this, & fanout_consumer::onValue);
+    }
+
+    void onValue (int value)
+    {
+        std::lock_guard<std::mutex> locker(__fanout_mtx);
+        __fanout_received[this->name()].push_back(value);
+        auto & hwm = __fanout_high_water_marks[this->name()];
+        hwm = (std::max)(hwm, this->queue()->high_water_mark());
+    }
+};
+
+TEST_CASE("Fan-out coalescing") {
+    using exit_status = modulus_t::exit_status;
+    modulus_t::dispatcher d{std::make_shared<modulus::iostream_logger>(), modulus::null_settings{}};
+
+    CHECK(d.register_module<fanout_consumer<modulus_t::runnable_module>>(std::make_pair("r", "")));
+    CHECK(d.register_module<fanout_consumer<modulus_t::guest_module>>(std::make_pair("g1", "r")));
+    CHECK(d.register_module<fanout_consumer<modulus_t::guest_module>>(std::make_pair("g2", "r")));
+    CHECK(d.register_module<fanout_consumer<modulus_t::guest_module>>(std::make_pair("g3", "r")));
+    CHECK(d.register_module<fanout_producer>(std::make_pair("p", "")));
+    CHECK(d.register_module<quit_by_timer>(std::make_pair("q", "")));
+
+    CHECK(d.exec() == exit_status::success);
+
+    std::vector<int> expected;
+
+    for (int i = 0; i < FANOUT_COUNT; i++)
+        expected.push_back(i);
+
+    CHECK_EQ(__fanout_received.size(), 4);
+
+    for (auto const & item: __fanout_received)
+        CHECK(item.second == expected);
+
+    // One action per emit for all detectors sharing the queue, emissions to
+    // guests are queued into their own subqueues (see
+    // dispatcher::queue_for())
+    for (auto name: {"r", "g1", "g2", "g3"}) {
+        CHECK_GE(__fanout_high_water_marks[name], 1);
+        CHECK_LE(__fanout_high_water_marks[name], FANOUT_COUNT);
+    }
+}
+
+static constexpr int FAIR_CHATTY_COUNT = 200;
+
+// Accessed from the thread of the "r" module only
+static int __fair_chatty_received = 0;
+static int __fair_chatty_at_quiet = -1;
+static std::size_t __fair_chatty_high_water_mark = 0;
+static std::size_t __fair_quiet_high_water_mark = 0;
+
+class fair_producer : public modulus_t::regular_module
+{
+    modulus_t::emitter_type<int> emitChatty;
+    modulus_t::emitter_type<int> emitQuiet;
+
+private:
+    void declare_emitters (modulus_t::module_context & ctx) override
+    {
+        ctx.declare_emitter(0, emitChatty);
+        ctx.declare_emitter(1, emitQuiet);
+    }
+
+    bool on_start () override
+    {
+        for (int i = 0; i < FAIR_CHATTY_COUNT; i++)
+            emitChatty(i);
+
+        emitQuiet(0);
+        return true;
+    }
+};
+
+class fair_parent : public modulus_t::runnable_module
+{};
+
+class fair_chatty_guest : public modulus_t::guest_module
+{
+private:
+    void declare_detectors (modulus_t::module_context & ctx) override
+    {
+        ctx.declare_detector(0);
+    }
+
+    bool connect_detector (modulus_t::api_id_type id
+        , modulus_t::module_context & ctx) override
+    {
+        return id == 0 && ctx.connect_detector(id, *this, & fair_chatty_guest::onValue);
+    }
+
+    void onValue (int)
+    {
+        // Backlog is built while the parent is busy
+        if (__fair_chatty_received++ == 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds{20});
+
+        __fair_chatty_high_water_mark = queue()->high_water_mark();
+    }
+};
+
+class fair_quiet_guest : public modulus_t::guest_module
+{
+private:
+    void declare_detectors (modulus_t::module_context & ctx) override
+    {
+        ctx.declare_detector(1);
+    }
+
+    bool connect_detector (modulus_t::api_id_type id
+        , modulus_t::module_context & ctx) override
+    {
+        return id == 1 && ctx.connect_detector(id, *this, & fair_quiet_guest::onValue);
+    }
+
+    void onValue (int)
+    {
+        __fair_chatty_at_quiet = __fair_chatty_received;
+        __fair_quiet_high_water_mark = queue()->high_water_mark();
+    }
+};
+
+TEST_CASE("Fan-out fairness between guests") {
+    using exit_status = modulus_t::exit_status;
+    modulus_t::dispatcher d{std::make_shared<modulus::iostream_logger>(), modulus::null_settings{}};
+
+    CHECK(d.register_module<fair_parent>(std::make_pair("r", "")));
+    CHECK(d.register_module<fair_chatty_guest>(std::make_pair("chatty", "r")));
+    CHECK(d.register_module<fair_quiet_guest>(std::make_pair("quiet", "r")));
+    CHECK(d.register_module<fair_producer>(std::make_pair("p", "")));
+    CHECK(d.register_module<quit_by_timer>(std::make_pair("q", "")));
+
+    CHECK(d.exec() == exit_status::success);
+
+    CHECK_EQ(__fair_chatty_received, FAIR_CHATTY_COUNT);
+
+    // Emission to the quiet guest is not delayed by the backlog of the
+    // chatty one
+    CHECK_GE(__fair_chatty_at_quiet, 1);
+    CHECK_LE(__fair_chatty_at_quiet, 4);
+
+    // Backlog is accounted to the chatty guest's subqueue
+    CHECK_GT(__fair_chatty_high_water_mark, FAIR_CHATTY_COUNT / 2);
+    CHECK_EQ(__fair_quiet_high_water_mark, 1);
+}
+
+// Accessed from the thread of the "src" module only
+static std::vector<int> __direct_received;
+static std::vector<bool> __direct_inline;
+static modulus_t::function_queue_type * __direct_sink_queue {nullptr};
+
+class direct_source : public modulus_t::runnable_module
+{
+    modulus_t::emitter_type<int> emitValue;
+
+private:
+    void declare_emitters (modulus_t::module_context & ctx) override
+    {
+        ctx.declare_emitter(1, emitValue);
+    }
+
+    bool on_start () override
+    {
+        start_timer(std::chrono::milliseconds{1}, [this] {
+            // Queue is empty: called inline
+            emitValue(1);
+            __direct_inline.push_back(__direct_received.size() == 1);
+
+            // Parent's queue has pending action: queued into the sink's
+            // subqueue
+            queue()->push([] { __direct_received.push_back(100); });
+            emitValue(2);
+            __direct_inline.push_back(__direct_received.size() == 2);
+
+            // Queued after the pending action of the sink's subqueue
+            __direct_sink_queue->push([] { __direct_received.push_back(200); });
+            emitValue(3);
+            __direct_inline.push_back(__direct_received.size() == 2);
+        });
+
+        return true;
+    }
+};
+
+class direct_sink : public modulus_t::guest_module
+{
+public:
+    direct_sink ()
+    {
+        __direct_sink_queue = queue();
+    }
+
+private:
+    void declare_detectors (modulus_t::module_context & ctx) override
+    {
+        ctx.declare_detector(1);
+    }
+
+    bool connect_detector (modulus_t::api_id_type id
+        , modulus_t::module_context & ctx) override
+    {
+        return id == 1 && ctx.connect_detector(id, *this, & direct_sink::onValue
+            , modulus::connection_mode::direct);
+    }
+
+    void onValue (int value)
+    {
+        __direct_received.push_back(value);
+    }
+};
+
+TEST_CASE("Direct connection") {
+    using exit_status = modulus_t::exit_status;
+    modulus_t::dispatcher d{std::make_shared<modulus::iostream_logger>(), modulus::null_settings{}};
+
+    CHECK(d.register_module<direct_source>(std::make_pair("src", "")));
+    CHECK(d.register_module<direct_sink>(std::make_pair("sink", "src")));
+    CHECK(d.register_module<quit_by_timer>(std::make_pair("q", "")));
+
+    CHECK(d.exec() == exit_status::success);
+
+    CHECK(__direct_inline == std::vector<bool>{true, false, false});
+
+    // Order of the parent's and the sink's actions is defined by their
+    // fairness share only
+    auto parent_action = std::find(__direct_received.begin(), __direct_received.end(), 100);
+    REQUIRE(parent_action != __direct_received.end());
+    __direct_received.erase(parent_action);
+    CHECK(__direct_received == std::vector<int>{1, 2, 200, 3});
+}
+
+static constexpr int TELEMETRY_COUNT = 1000;
+
+// Accessed from the thread of the "sink" module only
+static std::vector<int> __telemetry_received;
+static std::size_t __telemetry_high_water_mark = 0;
+
+class telemetry_source : public modulus_t::regular_module
+{
+    modulus_t::conflating_emitter<int> emitStatus;
+
+private:
+    void declare_emitters (modulus_t::module_context & ctx) override
+    {
+        ctx.declare_emitter(0, emitStatus);
+    }
+
+    bool on_start () override
+    {
+        for (int i = 0; i < TELEMETRY_COUNT; i++)
+            emitStatus(i);
+
+        return true;
+    }
+};
+
+class telemetry_sink : public modulus_t::runnable_module
+{
+private:
+    void declare_detectors (modulus_t::module_context & ctx) override
+    {
+        ctx.declare_detector(0);
+    }
+
+    bool connect_detector (modulus_t::api_id_type id
+        , modulus_t::module_context & ctx) override
+    {
+        return id == 0 && ctx.connect_detector(id, *this, & telemetry_sink::onStatus);
+    }
+
+    void onStatus (int value)
+    {
+        // Slow consumer
+        if (__telemetry_received.empty())
+            std::this_thread::sleep_for(std::chrono::milliseconds{5});
+
+        __telemetry_received.push_back(value);
+        __telemetry_high_water_mark = (std::max)(__telemetry_high_water_mark
+            , queue()->high_water_mark());
+    }
+};
+
+TEST_CASE("Conflating emitter") {
+    using exit_status = modulus_t::exit_status;
+    modulus_t::dispatcher d{std::make_shared<modulus::iostream_logger>(), modulus::null_settings{}};
+
+    CHECK(d.register_module<telemetry_sink>(std::make_pair("sink", "")));
+    CHECK(d.register_module<telemetry_source>(std::make_pair("src", "")));
+    CHECK(d.register_module<quit_by_timer>(std::make_pair("q", "")));
+
+    CHECK(d.exec() == exit_status::success);
+
+    REQUIRE_FALSE(__telemetry_received.empty());
+    CHECK_LT(__telemetry_received.size(), TELEMETRY_COUNT);
+    CHECK_EQ(__telemetry_received.back(), TELEMETRY_COUNT - 1);
+    CHECK(std::is_sorted(__telemetry_received.begin(), __telemetry_received.end()));
+    CHECK_LE(__telemetry_high_water_mark, 1);
+}
+
+enum class discard_path { drop_newest, drop_oldest, expiry };
+
+static discard_path __discard_path = discard_path::drop_newest;
+static std::atomic_bool __discard_sink_busy {false};
+static std::atomic_bool __discard_gate {false};
+static std::mutex __discard_mtx;
+static std::vector<int> __discard_received;
+
+template <typename Pred>
+static bool wait_until_true (Pred pred)
+{
+    for (int i = 0; i < 1000 && !pred(); i++)
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+
+    return pred();
+}
+
+static bool discard_received (int value)
+{
+    std::lock_guard<std::mutex> locker(__discard_mtx);
+    return std::find(__discard_received.begin(), __discard_received.end(), value)
+        != __discard_received.end();
+}
+
+class discard_source : public modulus_t::regular_module
+{
+    modulus_t::conflating_emitter<int> emitStatus;
+    modulus_t::emitter_type<int> emitControl;
+
+private:
+    void declare_emitters (modulus_t::module_context & ctx) override
+    {
+        ctx.declare_emitter(0, emitStatus);
+        ctx.declare_emitter(1, emitControl);
+    }
+
+    bool on_start () override
+    {
+        // Emit when the sink thread is consuming
+        start_timer(std::chrono::milliseconds{1}, [this] { produce(); });
+        start_timer(std::chrono::seconds{2}, [this] { quit(); });
+        return true;
+    }
+
+    void produce ()
+    {
+        // Block the sink, so the queue content is under control
+        emitControl(-1);
+        REQUIRE(wait_until_true([] { return __discard_sink_busy.load(); }));
+
+        switch (__discard_path) {
+            case discard_path::drop_newest:
+                emitControl(1);  // Fills the queue
+                emitStatus(10);  // Dropped
+                break;
+
+            case discard_path::drop_oldest:
+                emitStatus(10);  // Queued
+                emitControl(1);  // Evicts the delivery
+                break;
+
+            case discard_path::expiry: {
+                {
+                    modulus::deadline_scope scope {std::chrono::milliseconds{1}};
+                    emitStatus(10);
+                }
+
+                emitControl(1);
+                std::this_thread::sleep_for(std::chrono::milliseconds{5});
+                break;
+            }
+        }
+
+        __discard_gate = true;
+        REQUIRE(wait_until_true([] { return discard_received(1); }));
+
+        // Stream must not be stopped by the discarded delivery
+        emitStatus(20);
+    }
+};
+
+class discard_sink : public modulus_t::runnable_module
+{
+private:
+    bool connect_detector (modulus_t::api_id_type id
+        , modulus_t::module_context & ctx) override
+    {
+        switch (id) {
+            case 0:
+                return ctx.connect_detector(id, *this, & discard_sink::onStatus);
+            case 1:
+                return ctx.connect_detector(id, *this, & discard_sink::onControl);
+        }
+
+        return false;
+    }
+
+    void onControl (int value)
+    {
+        if (value < 0) {
+            __discard_sink_busy = true;
+            wait_until_true([] { return __discard_gate.load(); });
+            return;
+        }
+
+        std::lock_guard<std::mutex> locker(__discard_mtx);
+        __discard_received.push_back(value);
+    }
+
+    void onStatus (int value)
+    {
+        {
+            std::lock_guard<std::mutex> locker(__discard_mtx);
+            __discard_received.push_back(value);
+        }
+
+        if (value == 20)
+            quit();
+    }
+};
+
+TEST_CASE("Conflating emitter with discarded delivery") {
+    using exit_status = modulus_t::exit_status;
+
+    for (auto path: {discard_path::drop_newest, discard_path::drop_oldest, discard_path::expiry}) {
+        __discard_path = path;
+        __discard_sink_busy = false;
+        __discard_gate = false;
+        __discard_received.clear();
+
+        modulus_t::dispatcher d{std::make_shared<modulus::iostream_logger>(), modulus::null_settings{}};
+
+        CHECK(d.register_module<discard_sink>(std::make_pair("sink", "")));
+        CHECK(d.register_module<discard_source>(std::make_pair("src", "")));
+
+        if (path != discard_path::expiry) {
+            modulus::module_options opts;
+            opts.queue.capacity = 1;
+            opts.queue.overflow = path == discard_path::drop_newest
+                ? modulus::overflow_policy::drop_newest
+                : modulus::overflow_policy::drop_oldest;
+            CHECK(d.set_module_options("sink", opts));
+        }
+
+        CHECK(d.exec() == exit_status::success);
+        CHECK_EQ(__discard_received, std::vector<int>{1, 20});
+    }
+}
+
+static std::mutex __batch_mtx;
+static std::map<std::string, std::vector<std::size_t>> __batch_sizes;
+static std::map<std::string, int> __batch_sums;
+
+class batch_producer : public modulus_t::regular_module
+{
+    modulus_t::batch_emitter<int> emitEvents;
+
+private:
+    void declare_emitters (modulus_t::module_context & ctx) override
+    {
+        ctx.declare_emitter(0, emitEvents);
+    }
+
+    bool on_start () override
+    {
+        int events[] = {1, 2, 3, 4};
+
+        emitEvents.emit_batch(std::vector<int>{10, 20});
+        emitEvents.emit_batch(events, 4);
+        emitEvents.emit_batch(std::vector<int>{}); // Not emitted
+
+        return true;
+    }
+};
+
+template <typename BaseModule>
+class batch_consumer : public BaseModule
+{
+private:
+    void declare_detectors (modulus_t::module_context & ctx) override
+    {
+        ctx.declare_detector(0);
+    }
+
+    bool connect_detector (modulus_t::api_id_type id
+        , modulus_t::module_context & ctx) override
+    {
+        return id == 0 && ctx.connect_detector(id, *this, & batch_consumer::onEvents);
+    }
+
+    void onEvents (modulus::batch<int> events)
+    {
+        std::lock_guard<std::mutex> locker(__batch_mtx);
+        __batch_sizes[this->name()].push_back(events.size());
+
+        for (auto e: events)
+            __batch_sums[this->name()] += e;
+    }
+};
+
+TEST_CASE("Batch emitter") {
+    using exit_status = modulus_t::exit_status;
+    modulus_t::dispatcher d{std::make_shared<modulus::iostream_logger>(), modulus::null_settings{}};
+
+    CHECK(d.register_module<batch_consumer<modulus_t::runnable_module>>(std::make_pair("r", "")));
+    CHECK(d.register_module<batch_consumer<modulus_t::guest_module>>(std::make_pair("g", "r")));
+    CHECK(d.register_module<batch_consumer<modulus_t::regular_module>>(std::make_pair("c", "")));
+    CHECK(d.register_module<batch_producer>(std::make_pair("p", "")));
+    CHECK(d.register_module<quit_by_timer>(std::make_pair("q", "")));
+
+    CHECK(d.exec() == exit_status::success);
+
+    CHECK_EQ(__batch_sizes.size(), 3);
+
+    for (auto const & item: __batch_sizes)
+        CHECK(item.second == std::vector<std::size_t>{2, 4});
+
+    for (auto const & item: __batch_sums)
+        CHECK_EQ(item.second, 40);
+}
+
+static constexpr int SHARD_KEY_COUNT = 10;
+static constexpr int SHARD_EVENT_COUNT = 200;
+static std::mutex __shard_mtx;
+
+// Replica name -> (key, sequence number) pairs
+static std::map<std::string, std::vector<std::pair<int, int>>> __shard_received;
+
+class shard_producer : public modulus_t::regular_module
+{
+    modulus_t::emitter_type<int, int> emitEvent;
+
+private:
+    void declare_emitters (modulus_t::module_context & ctx) override
+    {
+        ctx.declare_emitter(0, emitEvent);
+    }
+
+    bool on_start () override
+    {
+        for (int i = 0; i < SHARD_EVENT_COUNT; i++)
+            emitEvent(i % SHARD_KEY_COUNT, i);
+
+        return true;
+    }
+};
+
+class shard_consumer : public modulus_t::runnable_module
+{
+private:
+    void declare_detectors (modulus_t::module_context & ctx) override
+    {
+        ctx.declare_detector(0);
+    }
+
+    bool connect_detector (modulus_t::api_id_type id
+        , modulus_t::module_context & ctx) override
+    {
+        return id == 0 && ctx.connect_sharded_detector(id, *this, & shard_consumer::onEvent
+            , [] (int key, int) { return key; });
+    }
+
+    void onEvent (int key, int seq)
+    {
+        std::lock_guard<std::mutex> locker(__shard_mtx);
+        __shard_received[name()].emplace_back(key, seq);
+    }
+};
+
+TEST_CASE("Sharded detectors") {
+    using exit_status = modulus_t::exit_status;
+    modulus_t::dispatcher d{std::make_shared<modulus::iostream_logger>(), modulus::null_settings{}};
+
+    CHECK(d.register_replicas<shard_consumer>(std::make_pair("shard", ""), 4));
+    CHECK(d.register_module<shard_producer>(std::make_pair("p", "")));
+    CHECK(d.register_module<quit_by_timer>(std::make_pair("q", "")));
+
+    CHECK(d.queue_for("shard.0") != nullptr);
+    CHECK(d.queue_for("shard.3") != nullptr);
+    CHECK(d.queue_for("shard.4") == nullptr);
+
+    CHECK(d.exec() == exit_status::success);
+
+    std::map<int, std::string> key_owner;
+    std::size_t total = 0;
+
+    for (auto const & item: __shard_received) {
+        int last_seq = -1;
+        total += item.second.size();
+
+        for (auto const & event: item.second) {
+            auto owner = key_owner.emplace(event.first, item.first).first->second;
+
+            // Each key is delivered to the single replica in emission order
+            CHECK_EQ(owner, item.first);
+            CHECK_GT(event.second, last_seq);
+            last_seq = event.second;
+        }
+    }
+
+    CHECK_EQ(total, SHARD_EVENT_COUNT);
+    CHECK_EQ(key_owner.size(), SHARD_KEY_COUNT);
+}
+
+static constexpr int BALANCED_EVENT_COUNT = 300;
+static modulus::balance_policy __balance_policy {modulus::balance_policy::round_robin};
+static std::mutex __balanced_mtx;
+static std::map<std::string, std::vector<int>> __balanced_received;
+
+class balanced_producer : public modulus_t::regular_module
+{
+    modulus_t::emitter_type<int> emitTask;
+
+private:
+    void declare_emitters (modulus_t::module_context & ctx) override
+    {
+        ctx.declare_emitter(0, emitTask);
+    }
+
+    bool on_start () override
+    {
+        for (int i = 0; i < BALANCED_EVENT_COUNT; i++)
+            emitTask(i);
+
+        return true;
+    }
+};
+
+class balanced_worker : public modulus_t::runnable_module
+{
+private:
+    void declare_detectors (modulus_t::module_context & ctx) override
+    {
+        ctx.declare_detector(0);
+    }
+
+    bool connect_detector (modulus_t::api_id_type id
+        , modulus_t::module_context & ctx) override
+    {
+        return id == 0 && ctx.connect_balanced_detector(id, *this
+            , & balanced_worker::onTask, __balance_policy);
+    }
+
+    void onTask (int task)
+    {
+        std::lock_guard<std::mutex> locker(__balanced_mtx);
+        __balanced_received[name()].push_back(task);
+    }
+};
+
+static void run_balanced (modulus::balance_policy policy)
+{
+    using exit_status = modulus_t::exit_status;
+    modulus_t::dispatcher d{std::make_shared<modulus::iostream_logger>(), modulus::null_settings{}};
+
+    __balance_policy = policy;
+    __balanced_received.clear();
+
+    CHECK(d.register_module<balanced_worker>(std::make_pair("w1", "")));
+    CHECK(d.register_module<balanced_worker>(std::make_pair("w2", "")));
+    CHECK(d.register_replicas<balanced_worker>(std::make_pair("w", ""), 2));
+    CHECK(d.register_module<balanced_producer>(std::make_pair("p", "")));
+    CHECK(d.register_module<quit_by_timer>(std::make_pair("q", "")));
+
+    CHECK(d.exec() == exit_status::success);
+}
+
+TEST_CASE("Balanced detectors") {
+    std::set<int> tasks;
+    std::size_t total = 0;
+
+    // Each pool (w1 and w2, replicas w.0 and w.1) receives every task once
+    run_balanced(modulus::balance_policy::round_robin);
+
+    REQUIRE_EQ(__balanced_received.size(), 4);
+
+    for (auto const & item: __balanced_received)
+        CHECK_EQ(item.second.size(), BALANCED_EVENT_COUNT / 2);
+
+    CHECK(__balanced_received["w1"] != __balanced_received["w2"]);
+    CHECK(__balanced_received["w.0"] != __balanced_received["w.1"]);
+
+    run_balanced(modulus::balance_policy::least_loaded);
+
+    for (auto const & name: {"w1", "w2"}) {
+        for (auto task: __balanced_received[name]) {
+            tasks.insert(task);
+            ++total;
+        }
+    }
+
+    CHECK_EQ(total, BALANCED_EVENT_COUNT);
+    CHECK_EQ(tasks.size(), BALANCED_EVENT_COUNT);
+}
+
+static std::atomic_int __distributed_tasks {0};
+static std::atomic_int __distributed_conflated {0};
+static std::atomic_int __distributed_conflating_connected {0};
+
+class distributed_producer : public modulus_t::regular_module
+{
+    modulus_t::emitter_type<int> emitTask;
+    modulus_t::conflating_emitter<int> emitLevel;
+
+private:
+    void declare_emitters (modulus_t::module_context & ctx) override
+    {
+        ctx.declare_emitter(0, emitTask);
+        ctx.declare_emitter(1, emitLevel);
+    }
+
+    bool on_start () override
+    {
+        for (int i = 0; i < BALANCED_EVENT_COUNT; i++) {
+            emitTask(i);
+            emitLevel(i);
+        }
+
+        return true;
+    }
+};
+
+class distributed_worker : public modulus_t::runnable_module
+{
+private:
+    void declare_detectors (modulus_t::module_context & ctx) override
+    {
+        ctx.declare_detector(0);
+        ctx.declare_detector(1);
+    }
+
+    bool connect_detector (modulus_t::api_id_type id
+        , modulus_t::module_context & ctx) override
+    {
+        if (id == 0) {
+            return ctx.connect_balanced_detector(id, *this, & distributed_worker::onTask
+                , modulus::balance_policy::round_robin, modulus::connection_mode::direct
+                , modulus::queue_priority::high);
+        }
+
+        auto connected = ctx.connect_sharded_detector(id, *this, & distributed_worker::onLevel
+            , [] (int) { return 0; });
+
+        if (connected)
+            ++__distributed_conflating_connected;
+
+        return connected;
+    }
+
+    void onTask (int)
+    {
+        ++__distributed_tasks;
+    }
+
+    void onLevel (int)
+    {
+        ++__distributed_conflated;
+    }
+};
+
+TEST_CASE("Distributed detectors connection options") {
+    using exit_status = modulus_t::exit_status;
+    modulus_t::dispatcher d{std::make_shared<modulus::iostream_logger>(), modulus::null_settings{}};
+
+    CHECK(d.register_replicas<distributed_worker>(std::make_pair("w", ""), 2));
+    CHECK(d.register_module<distributed_producer>(std::make_pair("p", "")));
+    CHECK(d.register_module<quit_by_timer>(std::make_pair("q", "")));
+    CHECK(d.exec() == exit_status::success);
+
+    CHECK_EQ(__distributed_tasks.load(), BALANCED_EVENT_COUNT);
+
+    // Conflating emitter is not connected to sharded detectors
+    CHECK_EQ(__distributed_conflating_connected.load(), 0);
+    CHECK_EQ(__distributed_conflated.load(), 0);
+}
+
+// Accessed from the thread of the "client" module only
+static int __rpc_sum = 0;
+static int __rpc_product = 0;
+static bool __rpc_callback_in_caller_queue = false;
+static modulus::rpc_status __rpc_unanswered_status = modulus::rpc_status::success;
+static int __rpc_notifications = 0;
+
+class rpc_client : public modulus_t::runnable_module
+{
+    modulus_t::rpc_emitter<int (int, int)> callAdd;
+    modulus_t::rpc_emitter<int (int, int)> callMultiply;
+    modulus_t::rpc_emitter<void (int)> callNotify;
+    modulus_t::rpc_emitter<int ()> callUnanswered;
+
+private:
+    void declare_emitters (modulus_t::module_context & ctx) override
+    {
+        ctx.declare_emitter(0, callAdd);
+        ctx.declare_emitter(1, callMultiply);
+        ctx.declare_emitter(2, callNotify);
+        ctx.declare_emitter(3, callUnanswered);
+    }
+
+    bool on_start () override
+    {
+        start_timer(std::chrono::milliseconds{1}, [this] {
+            callAdd.call(std::chrono::seconds{1}, [this] (modulus::rpc_result<int> && r) {
+                __rpc_callback_in_caller_queue = queue()->is_consumer_thread();
+                __rpc_sum = r.ok() ? r.value() : -1;
+            }, 2, 3);
+
+            callNotify.call(std::chrono::seconds{1}, [] (modulus::rpc_result<void> && r) {
+                if (r.ok())
+                    __rpc_notifications++;
+            }, 1);
+
+            callUnanswered.call(std::chrono::milliseconds{10}, [] (modulus::rpc_result<int> && r) {
+                __rpc_unanswered_status = r.status();
+            });
+
+            // Callee runs in other thread, so waiting is safe
+            auto f = callMultiply.call_future(std::chrono::seconds{1}, 6, 7);
+            auto r = f.get();
+            __rpc_product = r.ok() ? r.value() : -1;
+        });
+
+        return true;
+    }
+};
+
+// Callback of regular module is processed from the dispatcher's queue
+static std::atomic_int __rpc_regular_sum {0};
+static std::atomic_bool __rpc_regular_callback_in_caller_thread {false};
+
+class rpc_regular_client : public modulus_t::regular_module
+{
+    modulus_t::rpc_emitter<int (int, int)> callAdd;
+
+private:
+    void declare_emitters (modulus_t::module_context & ctx) override
+    {
+        ctx.declare_emitter(0, callAdd);
+    }
+
+    bool on_start () override
+    {
+        start_timer(std::chrono::milliseconds{1}, [this] {
+            auto caller = std::this_thread::get_id();
+
+            callAdd.call(std::chrono::seconds{1}, [caller] (modulus::rpc_result<int> && r) {
+                __rpc_regular_callback_in_caller_thread = std::this_thread::get_id() == caller;
+                __rpc_regular_sum = r.ok() ? r.value() : -1;
+            }, 4, 5);
+        });
+
+        return true;
+    }
+};
+
+class rpc_server : public modulus_t::runnable_module
+{
+private:
+    void declare_detectors (modulus_t::module_context & ctx) override
+    {
+        ctx.declare_detector(0);
+        ctx.declare_detector(1);
+        ctx.declare_detector(2);
+    }
+
+    bool connect_detector (modulus_t::api_id_type id
+        , modulus_t::module_context & ctx) override
+    {
+        switch (id) {
+            case 0: return ctx.connect_rpc_detector(id, *this, & rpc_server::add);
+            case 1: return ctx.connect_rpc_detector(id, *this, & rpc_server::multiply);
+            case 2: return ctx.connect_rpc_detector(id, *this, & rpc_server::notify);
+            default: break;
+        }
+
+        return false;
+    }
+
+    int add (int a, int b) { return a + b; }
+    int multiply (int a, int b) { return a * b; }
+    void notify (int) {}
+};
+
+TEST_CASE("Remote procedure call") {
+    using exit_status = modulus_t::exit_status;
+    modulus_t::dispatcher d{std::make_shared<modulus::iostream_logger>(), modulus::null_settings{}};
+
+    CHECK(d.register_module<rpc_server>(std::make_pair("server", "")));
+    CHECK(d.register_module<rpc_client>(std::make_pair("client", "")));
+    CHECK(d.register_module<rpc_regular_client>(std::make_pair("regular_client", "")));
+    CHECK(d.register_module<quit_by_timer>(std::make_pair("q", "")));
+
+    CHECK(d.exec() == exit_status::success);
+
+    CHECK_EQ(__rpc_sum, 5);
+    CHECK_EQ(__rpc_regular_sum, 9);
+    CHECK(__rpc_regular_callback_in_caller_thread);
+    CHECK(__rpc_callback_in_caller_queue);
+    CHECK_EQ(__rpc_product, 42);
+    CHECK_EQ(__rpc_notifications, 1);
+    CHECK(__rpc_unanswered_status == modulus::rpc_status::timeout);
+}
+
+// Accessed from the thread of the "client" module only
+static modulus::rpc_status __rpc_dropped_status = modulus::rpc_status::success;
+static int __rpc_dropped_callbacks = 0;
+
+class rpc_saturated_client : public modulus_t::runnable_module
+{
+    modulus_t::rpc_emitter<int (int, int)> callAdd;
+
+private:
+    void declare_emitters (modulus_t::module_context & ctx) override
+    {
+        ctx.declare_emitter(0, callAdd);
+    }
+
+    bool on_start () override
+    {
+        start_timer(std::chrono::milliseconds{1}, [this] {
+            // Queue is full (capacity is 1) while the reply arrives
+            queue()->push([] {});
+
+            callAdd.call(std::chrono::seconds{1}, [] (modulus::rpc_result<int> && r) {
+                __rpc_dropped_status = r.status();
+                ++__rpc_dropped_callbacks;
+            }, 2, 3);
+
+            auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds{1};
+
+            while (queue()->dropped_count() + queue()->rejected_count() == 0
+                    && std::chrono::steady_clock::now() < timeout) {
+                std::this_thread::sleep_for(std::chrono::milliseconds{1});
+            }
+        });
+
+        return true;
+    }
+};
+
+TEST_CASE("Remote procedure call reply dropped") {
+    using exit_status = modulus_t::exit_status;
+
+    for (auto overflow: {modulus::overflow_policy::drop_newest, modulus::overflow_policy::fail}) {
+        __rpc_dropped_status = modulus::rpc_status::success;
+        __rpc_dropped_callbacks = 0;
+
+        modulus_t::dispatcher d{std::make_shared<modulus::iostream_logger>(), modulus::null_settings{}};
+        modulus::module_options opts;
+        opts.queue.capacity = 1;
+        opts.queue.overflow = overflow;
+
+        CHECK(d.register_module<rpc_server>(std::make_pair("server", "")));
+        CHECK(d.register_module<rpc_saturated_client>(std::make_pair("client", "")));
+        CHECK(d.register_module<quit_by_timer>(std::make_pair("q", "")));
+        CHECK(d.set_module_options("client", opts));
+        CHECK(d.exec() == exit_status::success);
+
+        // Callback is called once with error instead of the dropped reply
+        CHECK_EQ(__rpc_dropped_callbacks, 1);
+        CHECK(__rpc_dropped_status == modulus::rpc_status::dropped);
+    }
+}
+
+static constexpr int TTL_EVENT_COUNT = 10;
+
+// Accessed from the thread of the "sink" module only
+static std::vector<int> __ttl_received;
+static std::size_t __ttl_expired = 0;
+
+class ttl_source : public modulus_t::regular_module
+{
+    modulus_t::ttl_emitter<int> emitEvent;
+
+private:
+    void declare_emitters (modulus_t::module_context & ctx) override
+    {
+        emitEvent.set_ttl(std::chrono::milliseconds{5});
+        ctx.declare_emitter(0, emitEvent);
+    }
+
+    bool on_start () override
+    {
+        for (int i = 0; i < TTL_EVENT_COUNT; i++)
+            emitEvent(i);
+
+        return true;
+    }
+};
+
+class ttl_sink : public modulus_t::runnable_module
+{
+private:
+    void declare_detectors (modulus_t::module_context & ctx) override
+    {
+        ctx.declare_detector(0);
+    }
+
+    bool connect_detector (modulus_t::api_id_type id
+        , modulus_t::module_context & ctx) override
+    {
+        return id == 0 && ctx.connect_detector(id, *this, & ttl_sink::onEvent);
+    }
+
+    bool on_start () override
+    {
+        start_timer(std::chrono::milliseconds{40}, [this] {
+            __ttl_expired = queue()->expired_count();
+        });
+
+        return true;
+    }
+
+    void onEvent (int value)
+    {
+        // Overloaded consumer: the rest of events become stale
+        if (__ttl_received.empty())
+            std::this_thread::sleep_for(std::chrono::milliseconds{20});
+
+        __ttl_received.push_back(value);
+    }
+};
+
+// Regular module re-emitting events of the TTL emitter (called inline from
+// the emission)
+class ttl_relay : public modulus_t::regular_module
+{
+    modulus_t::emitter_type<int> emitRelayed;
+
+private:
+    void declare_emitters (modulus_t::module_context & ctx) override
+    {
+        ctx.declare_emitter(1, emitRelayed);
+    }
+
+    void declare_detectors (modulus_t::module_context & ctx) override
+    {
+        ctx.declare_detector(0);
+    }
+
+    bool connect_detector (modulus_t::api_id_type id
+        , modulus_t::module_context & ctx) override
+    {
+        return id == 0 && ctx.connect_detector(id, *this, & ttl_relay::onEvent);
+    }
+
+    void onEvent (int value)
+    {
+        emitRelayed(value);
+    }
+};
+
+// Accessed from the thread of the "relay_sink" module only
+static std::size_t __ttl_relayed = 0;
+
+class ttl_relay_sink : public modulus_t::runnable_module
+{
+private:
+    void declare_detectors (modulus_t::module_context & ctx) override
+    {
+        ctx.declare_detector(1);
+    }
+
+    bool connect_detector (modulus_t::api_id_type id
+        , modulus_t::module_context & ctx) override
+    {
+        return id == 1 && ctx.connect_detector(id, *this, & ttl_relay_sink::onRelayed);
+    }
+
+    void onRelayed (int)
+    {
+        // Overloaded as ttl_sink, but relayed events are not limited by TTL
+        if (__ttl_relayed++ == 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds{20});
+    }
+};
+
+TEST_CASE("Emitter with time to live") {
+    using exit_status = modulus_t::exit_status;
+    modulus_t::dispatcher d{std::make_shared<modulus::iostream_logger>(), modulus::null_settings{}};
+
+    CHECK(d.register_module<ttl_sink>(std::make_pair("sink", "")));
+    CHECK(d.register_module<ttl_relay_sink>(std::make_pair("relay_sink", "")));
+    CHECK(d.register_module<ttl_relay>(std::make_pair("relay", "")));
+    CHECK(d.register_module<ttl_source>(std::make_pair("src", "")));
+    CHECK(d.register_module<quit_by_timer>(std::make_pair("q", "")));
+
+    CHECK(d.exec() == exit_status::success);
+
+    REQUIRE_FALSE(__ttl_received.empty());
+    CHECK_LT(__ttl_received.size(), TTL_EVENT_COUNT);
+    CHECK_EQ(__ttl_received.size() + __ttl_expired, TTL_EVENT_COUNT);
+
+    // Emissions of the detector called inline do not inherit TTL
+    CHECK_EQ(__ttl_relayed, TTL_EVENT_COUNT);
+}
+
+class pooled_producer : public modulus_t::regular_module
+{
+    modulus_t::emitter_type<int> emitValue;
+
+private:
+    void declare_emitters (modulus_t::module_context & ctx) override
+    {
+        ctx.declare_emitter(0, emitValue);
+    }
+
+    bool on_start () override
+    {
+        for (int i = 1; i <= 100; i++)
+            emitValue(i);
+
+        return true;
+    }
+};
+
+std::atomic_int __pooled_sum {0};
+std::atomic_int __pooled_finished {0};
+std::mutex __pooled_threads_mtx;
+std::set<std::thread::id> __pooled_threads;
+
+class pooled_consumer : public modulus_t::runnable_module
+{
+    int _sum = 0;
+
+private:
+    bool connect_detector (modulus_t::api_id_type id, modulus_t::module_context & ctx) override
+    {
+        switch (id) {
+            case 0:
+                return ctx.connect_detector(id, *this, & pooled_consumer::onValue);
+        }
+
+        return false;
+    }
+
+    void onValue (int value)
+    {
+        {
+            std::unique_lock<std::mutex> locker(__pooled_threads_mtx);
+            __pooled_threads.insert(std::this_thread::get_id());
+        }
+
+        _sum += value;
+
+        if (_sum == 5050) {
+            __pooled_sum += _sum;
+
+            if (++__pooled_finished == 20)
+                quit();
+        }
+    }
+};
+
+class blocking_runnable : public modulus_t::runnable_module
+{
+public:
+    bool started = false;
+
+    modulus_t::exit_status run () override
+    {
+        started = true;
+
+        while (! is_quit())
+            wait_for(std::chrono::milliseconds(10));
+
+        return modulus_t::exit_status::success;
+    }
+
+    ~blocking_runnable ()
+    {
+        CHECK(started);
+    }
+};
+
+TEST_CASE("Worker pool execution") {
+    using exit_status = modulus_t::exit_status;
+    modulus_t::dispatcher d{std::make_shared<modulus::iostream_logger>(), modulus::null_settings{}};
+    modulus::timer_quit_plugin timer_quit_plugin {5};
+
+    d.enable_worker_pool(2);
+
+    CHECK(d.register_module<pooled_producer>(std::make_pair("producer", "")));
+
+    for (int i = 0; i < 20; i++)
+        CHECK(d.register_module<pooled_consumer>(std::make_pair("consumer" + std::to_string(i), "")));
+
+    CHECK(d.register_module<blocking_runnable>(std::make_pair("blocking", "")));
+
+    modulus::module_options opts;
+    opts.dedicated_thread = true;
+    CHECK(d.set_module_options("blocking", opts));
+
+    d.attach_plugin(timer_quit_plugin);
+    CHECK(d.exec() == exit_status::success);
+    timer_quit_plugin.stop();
+
+    CHECK_FALSE(timer_quit_plugin.timedout());
+    CHECK_EQ(__pooled_finished.load(), 20);
+    CHECK_EQ(__pooled_sum.load(), 20 * 5050);
+    CHECK_LE(__pooled_threads.size(), 2);
+}
+
+static std::atomic<int> __overridden_run_calls {0};
+
+class overriding_runnable : public modulus_t::runnable_module
+{
+private:
+    modulus_t::exit_status run () override
+    {
+        ++__overridden_run_calls;
+        return runnable_module::run();
+    }
+
+    bool on_start () override
+    {
+        queue()->push([this] { quit(); });
+        return true;
+    }
+};
+
+class pooled_poller : public modulus_t::runnable_module
+{
+public:
+    pooled_poller ()
+    {
+        set_poll_interval(std::chrono::milliseconds{1}, std::chrono::microseconds{100});
+    }
+};
+
+TEST_CASE("Worker pool limits") {
+    using exit_status = modulus_t::exit_status;
+
+    // Producers blocked on full queues may occupy all pool threads
+    {
+        modulus_t::dispatcher d{std::make_shared<modulus::iostream_logger>(), modulus::null_settings{}};
+        d.enable_worker_pool(2);
+
+        CHECK(d.register_module<pooled_consumer>(std::make_pair("bounded", "")));
+
+        modulus::module_options opts;
+        opts.queue.capacity = 4;
+        opts.queue.overflow = modulus::overflow_policy::block;
+        CHECK(d.set_module_options("bounded", opts));
+
+        CHECK(d.exec() == exit_status::failure);
+    }
+
+    // Overridden run() is never called on worker pool
+    {
+        modulus_t::dispatcher d{std::make_shared<modulus::iostream_logger>(), modulus::null_settings{}};
+        d.enable_worker_pool(2);
+
+        CHECK(d.register_module<overriding_runnable>(std::make_pair("pooled", "")));
+        CHECK(d.exec() == exit_status::failure);
+    }
+
+    // Poll loop requires dedicated thread
+    {
+        modulus_t::dispatcher d{std::make_shared<modulus::iostream_logger>(), modulus::null_settings{}};
+        d.enable_worker_pool(2);
+
+        CHECK(d.register_module<pooled_poller>(std::make_pair("poller", "")));
+        CHECK(d.exec() == exit_status::failure);
+    }
+
+    // Overridden run() is called for module run in dedicated thread only
+    {
+        modulus_t::dispatcher d{std::make_shared<modulus::iostream_logger>(), modulus::null_settings{}};
+        modulus::timer_quit_plugin timer_quit_plugin {5};
+        d.enable_worker_pool(2);
+
+        CHECK(d.register_module<overriding_runnable>(std::make_pair("dedicated", "")));
+
+        modulus::module_options opts;
+        opts.dedicated_thread = true;
+        CHECK(d.set_module_options("dedicated", opts));
+
+        d.attach_plugin(timer_quit_plugin);
+        CHECK(d.exec() == exit_status::success);
+        timer_quit_plugin.stop();
+
+        CHECK_FALSE(timer_quit_plugin.timedout());
+        CHECK_EQ(__overridden_run_calls.load(), 1);
+    }
+}
+
+static constexpr int POLLED_COUNT = 200;
+
+// Accessed from the thread of the "poller" module only
+static int __polled_processed = 0;
+static std::vector<int> __polled_progress;
+
+class poller : public modulus_t::runnable_module
+{
+public:
+    poller ()
+    {
+        set_poll_interval(std::chrono::milliseconds{1}, std::chrono::microseconds{200});
+    }
+
+    ~poller ()
+    {
+        CHECK_EQ(poll_count(), __polled_progress.size());
+        CHECK_GT(budget_exhausted_count(), 0);
+    }
+
+private:
+    bool on_start () override
+    {
+        // Burst of slow actions
+        for (int i = 0; i < POLLED_COUNT; i++) {
+            queue()->push([] {
+                std::this_thread::sleep_for(std::chrono::microseconds{50});
+                ++__polled_processed;
+            });
+        }
+
+        return true;
+    }
+
+    void on_poll () override
+    {
+        __polled_progress.push_back(__polled_processed);
+
+        if (__polled_processed == POLLED_COUNT)
+            quit();
+    }
+};
+
+TEST_CASE("Poll loop") {
+    using exit_status = modulus_t::exit_status;
+    modulus_t::dispatcher d{std::make_shared<modulus::iostream_logger>(), modulus::null_settings{}};
+    modulus::timer_quit_plugin timer_quit_plugin {5};
+
+    CHECK(d.register_module<poller>(std::make_pair("poller", "")));
+
+    d.attach_plugin(timer_quit_plugin);
+    CHECK(d.exec() == exit_status::success);
+    timer_quit_plugin.stop();
+
+    CHECK_FALSE(timer_quit_plugin.timedout());
+    CHECK_EQ(__polled_processed, POLLED_COUNT);
+
+    // Polled while the burst was being processed
+    CHECK(std::any_of(__polled_progress.begin(), __polled_progress.end()
+        , [] (int n) { return n > 0 && n < POLLED_COUNT; }));
+}
+
+#if MODULUS__REACTOR_ENABLED
+
+static std::atomic<int> __fd_done {0};
+static std::atomic<int> __fd_foreign_thread_calls {0};
+
+// Reads "ping" written by two timer callbacks to the pipe watched in the
+// module's thread (dispatcher's thread for regular module)
+template <typename ModuleClass>
+class fd_reader : public ModuleClass
+{
+    int _fds[2] {-1, -1};
+    std::thread::id _thread_id;
+    std::string _received;
+
+public:
+    ~fd_reader ()
+    {
+        CHECK_EQ(_received, "ping");
+
+        ::close(_fds[0]);
+        ::close(_fds[1]);
+    }
+
+private:
+    bool on_start () override
+    {
+        REQUIRE(::pipe(_fds) == 0);
+
+        this->start_timer(std::chrono::milliseconds{1}, [this] {
+            _thread_id = std::this_thread::get_id();
+
+            CHECK(this->watch_fd(_fds[0], modulus::io_read, [this] (unsigned events) {
+                CHECK((events & modulus::io_read) != 0);
+
+                if (std::this_thread::get_id() != _thread_id)
+                    ++__fd_foreign_thread_calls;
+
+                char buf[16];
+                auto n = ::read(_fds[0], buf, sizeof(buf));
+
+                if (n > 0)
+                    _received.append(buf, static_cast<std::size_t>(n));
+
+                if (_received == "ping") {
+                    CHECK(this->unwatch_fd(_fds[0]));
+
+                    if (++__fd_done == 2)
+                        this->quit();
+                }
+            }));
+
+            CHECK_EQ(::write(_fds[1], "pi", 2), 2);
+        });
+
+        // Queued action wakes up the thread waiting for descriptors
+        this->start_timer(std::chrono::milliseconds{20}, [this] {
+            CHECK_EQ(::write(_fds[1], "ng", 2), 2);
+        });
+
+        return true;
+    }
+};
+
+TEST_CASE("Watching file descriptors") {
+    using exit_status = modulus_t::exit_status;
+    modulus_t::dispatcher d{std::make_shared<modulus::iostream_logger>(), modulus::null_settings{}};
+    modulus::timer_quit_plugin timer_quit_plugin {5};
+
+    CHECK(d.register_module<fd_reader<modulus_t::runnable_module>>(std::make_pair("r", "")));
+    CHECK(d.register_module<fd_reader<modulus_t::regular_module>>(std::make_pair("g", "")));
+
+    d.attach_plugin(timer_quit_plugin);
+    CHECK(d.exec() == exit_status::success);
+    timer_quit_plugin.stop();
+
+    CHECK_FALSE(timer_quit_plugin.timedout());
+    CHECK_EQ(__fd_done.load(), 2);
+    CHECK_EQ(__fd_foreign_thread_calls.load(), 0);
+}
+
+static std::atomic<int> __pooled_watch_result {-1};
+
+class pooled_fd_watcher : public modulus_t::runnable_module
+{
+    int _fds[2] {-1, -1};
+
+public:
+    ~pooled_fd_watcher ()
+    {
+        ::close(_fds[0]);
+        ::close(_fds[1]);
+    }
+
+private:
+    bool on_start () override
+    {
+        REQUIRE(::pipe(_fds) == 0);
+
+        __pooled_watch_result = watch_fd(_fds[0], modulus::io_read, [] (unsigned) {}) ? 1 : 0;
+        quit();
+
+        return true;
+    }
+};
+
+TEST_CASE("Watching file descriptors on worker pool") {
+    using exit_status = modulus_t::exit_status;
+    modulus_t::dispatcher d{std::make_shared<modulus::iostream_logger>(), modulus::null_settings{}};
+    d.enable_worker_pool(1);
+
+    CHECK(d.register_module<pooled_fd_watcher>(std::make_pair("watcher", "")));
+    CHECK(d.exec() == exit_status::success);
+
+    // Worker pool thread does not wait for descriptors
+    CHECK_EQ(__pooled_watch_result.load(), 0);
+}
+
+#endif // MODULUS__REACTOR_ENABLED
+
+#if MODULUS__IO_SERVICE_ENABLED
+
+static std::atomic<int> __io_done {0};
+static std::atomic<int> __io_foreign_thread_callbacks {0};
+
+// Writes record to the temporary file, flushes and reads it back. Callbacks
+// must be processed in the module's thread (dispatcher's thread for regular
+// module).
+template <typename ModuleClass>
+class io_journal : public ModuleClass
+{
+    int _fd {-1};
+    std::thread::id _thread_id;
+    std::string const _record {"journal record"};
+    char _buf[32] {};
+    std::string _read_back;
+
+public:
+    ~io_journal ()
+    {
+        CHECK_EQ(_read_back, _record);
+
+        if (_fd >= 0)
+            ::close(_fd);
+    }
+
+private:
+    void check_thread ()
+    {
+        if (std::this_thread::get_id() != _thread_id)
+            ++__io_foreign_thread_callbacks;
+    }
+
+    bool on_start () override
+    {
+        char path[] = "/tmp/modulus-io-XXXXXX";
+        _fd = ::mkstemp(path);
+        REQUIRE(_fd >= 0);
+        ::unlink(path);
+
+        this->start_timer(std::chrono::milliseconds{1}, [this] {
+            _thread_id = std::this_thread::get_id();
+
+            CHECK(this->async_write(_fd, _record.data(), _record.size(), 0
+                    , [this] (modulus::io_result r) {
+                check_thread();
+                CHECK(r.ok());
+                CHECK_EQ(r.bytes, _record.size());
+            }));
+
+            CHECK(this->async_fsync(_fd, [this] (modulus::io_result r) {
+                check_thread();
+                CHECK(r.ok());
+
+                CHECK(this->async_read(_fd, _buf, sizeof(_buf), 0, [this] (modulus::io_result r) {
+                    check_thread();
+                    CHECK(r.ok());
+                    _read_back.assign(_buf, r.bytes);
+
+                    if (++__io_done % 2 == 0)
+                        this->quit();
+                }));
+            }));
+        });
+
+        return true;
+    }
+};
+
+TEST_CASE("Asynchronous file I/O") {
+    using exit_status = modulus_t::exit_status;
+
+    for (auto backend: {modulus::io_backend::io_uring, modulus::io_backend::thread_pool}) {
+        modulus_t::dispatcher d{std::make_shared<modulus::iostream_logger>(), modulus::null_settings{}};
+        modulus::timer_quit_plugin timer_quit_plugin {5};
+
+        d.enable_io_service(backend);
+
+        CHECK(d.register_module<io_journal<modulus_t::runnable_module>>(std::make_pair("r", "")));
+        CHECK(d.register_module<io_journal<modulus_t::regular_module>>(std::make_pair("g", "")));
+
+        d.attach_plugin(timer_quit_plugin);
+        CHECK(d.exec() == exit_status::success);
+        timer_quit_plugin.stop();
+
+        CHECK_FALSE(timer_quit_plugin.timedout());
+    }
+
+    CHECK_EQ(__io_done.load(), 4);
+    CHECK_EQ(__io_foreign_thread_callbacks.load(), 0);
+}
+
+// Checks fsync starts after previous operations complete and operations
+// submitted after it wait for its completion (callbacks are called from the
+// service threads)
+static void check_fsync_barrier (modulus::basic_io_service<modulus_t::function_queue_type> & service)
+{
+    int pipe_fds[2] {-1, -1};
+    REQUIRE(::pipe(pipe_fds) == 0);
+
+    char path[] = "/tmp/modulus-io-XXXXXX";
+    int fd = ::mkstemp(path);
+    REQUIRE(fd >= 0);
+    ::unlink(path);
+
+    std::mutex mtx;
+    std::vector<std::string> completed;
+    char buf[4] {};
+
+    auto record = [& mtx, & completed] (std::string const & name) {
+        return [& mtx, & completed, name] (modulus::io_result) {
+            std::lock_guard<std::mutex> locker(mtx);
+            completed.push_back(name);
+        };
+    };
+
+    // Blocked until the pipe is written
+    CHECK(service.read(pipe_fds[0], buf, sizeof(buf), -1, nullptr, record("read")));
+    CHECK(service.fsync(fd, false, nullptr, record("fsync")));
+    CHECK(service.write(fd, "x", 1, 0, nullptr, record("write")));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{20});
+
+    {
+        std::lock_guard<std::mutex> locker(mtx);
+        CHECK(completed.empty());
+    }
+
+    CHECK_EQ(::write(pipe_fds[1], "ping", 4), 4);
+    service.stop();
+
+    CHECK(completed == std::vector<std::string>{"read", "fsync", "write"});
+
+    ::close(fd);
+    ::close(pipe_fds[0]);
+    ::close(pipe_fds[1]);
+}
+
+TEST_CASE("Asynchronous file I/O ordering") {
+    {
+        modulus::thread_pool_io_service<modulus_t::function_queue_type> service {4};
+        check_fsync_barrier(service);
+    }
+
+#if MODULUS__IO_URING_ENABLED
+    {
+        modulus::io_uring_service<modulus_t::function_queue_type> service;
+
+        if (service.open().empty())
+            check_fsync_barrier(service);
+    }
+#endif
+}
+
+#if MODULUS__IO_URING_ENABLED
+TEST_CASE("Asynchronous file I/O size limit") {
+    modulus::io_uring_service<modulus_t::function_queue_type> service;
+
+    if (!service.open().empty() || sizeof(std::size_t) <= 4)
+        return;
+
+    char path[] = "/tmp/modulus-io-XXXXXX";
+    int fd = ::mkstemp(path);
+    REQUIRE(fd >= 0);
+    ::unlink(path);
+    REQUIRE(::write(fd, "hello", 5) == 5);
+
+    // Size is not truncated to 32 bits (zero), buffer is reserved only
+    auto size = static_cast<std::size_t>(std::uint64_t{1} << 32);
+    auto buf = ::mmap(nullptr, size, PROT_READ | PROT_WRITE
+        , MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+    if (buf == MAP_FAILED) {
+        ::close(fd);
+        return;
+    }
+
+    std::atomic<std::size_t> bytes {0};
+
+    CHECK(service.read(fd, buf, size, 0, nullptr, [& bytes] (modulus::io_result r) {
+        CHECK(r.ok());
+        bytes = r.bytes;
+    }));
+
+    service.stop();
+    CHECK_EQ(bytes.load(), 5);
+    CHECK_EQ(std::string(static_cast<char *>(buf), 5), "hello");
+
+    ::munmap(buf, size);
+    ::close(fd);
+}
+#endif
+
+#endif // MODULUS__IO_SERVICE_ENABLED
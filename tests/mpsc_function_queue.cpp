@@ -0,0 +1,160 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Vladislav Trifochkin
+//
+// License: see LICENSE file
+//
+// This file is part of `modulus2-lib`.
+//
+// Changelog:
+//      2026.10.17 Initial version.
+////////////////////////////////////////////////////////////////////////////////
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "pfs/modulus/modulus.hpp"
+#include "pfs/modulus/iostream_logger.hpp"
+#include "pfs/modulus/mpsc_function_queue.hpp"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+TEST_CASE("mpsc_function_queue basics") {
+    modulus::mpsc_function_queue q;
+    int counter = 0;
+
+    CHECK(q.empty());
+    CHECK_EQ(q.call_all(), 0);
+
+    q.push([& counter] { counter++; });
+    q.push([& counter] (int n) { counter += n; }, 10);
+
+    CHECK_FALSE(q.empty());
+    CHECK_EQ(q.call(), 1);
+    CHECK_EQ(counter, 1);
+    CHECK_EQ(q.call_all(), 1);
+    CHECK_EQ(counter, 11);
+    CHECK(q.empty());
+
+    for (int i = 0; i < 5; i++)
+        q.push([& counter] { counter++; });
+
+    CHECK_EQ(q.call(3), 3);
+    CHECK_EQ(q.call_all(), 2);
+    CHECK_EQ(counter, 16);
+
+    CHECK_FALSE(q.wait_for(1000));
+}
+
+TEST_CASE("mpsc_function_queue call_all does not call actions pushed while calling") {
+    modulus::mpsc_function_queue q;
+    int counter = 0;
+
+    q.push([& q, & counter] {
+        counter++;
+        q.push([& counter] { counter++; });
+    });
+
+    CHECK_EQ(q.call_all(), 1);
+    CHECK_EQ(counter, 1);
+    CHECK_EQ(q.call_all(), 1);
+    CHECK_EQ(counter, 2);
+}
+
+TEST_CASE("mpsc_function_queue multiple producers") {
+    constexpr int producer_count = 4;
+    constexpr int items_per_producer = 100000;
+
+    modulus::mpsc_function_queue q;
+    std::vector<int> last_seen(producer_count, -1);
+    std::atomic_int total {0};
+    bool ordered = true;
+
+    std::vector<std::thread> producers;
+
+    for (int p = 0; p < producer_count; p++) {
+        producers.emplace_back([&, p] {
+            for (int i = 0; i < items_per_producer; i++) {
+                q.push([&, p, i] {
+                    if (last_seen[p] + 1 != i)
+                        ordered = false;
+
+                    last_seen[p] = i;
+                    ++total;
+                });
+            }
+        });
+    }
+
+    while (total < producer_count * items_per_producer) {
+        q.wait_for(10000);
+        q.call_all();
+    }
+
+    for (auto & th: producers)
+        th.join();
+
+    CHECK(ordered);
+    CHECK_EQ(total.load(), producer_count * items_per_producer);
+    CHECK(q.empty());
+}
+
+using modulus_t = modulus::modulus<modulus::iostream_logger, modulus::null_settings
+    , int, modulus::mpsc_function_queue>;
+
+class producer : public modulus_t::regular_module
+{
+public:
+    modulus_t::emitter_type<int> emitValue;
+
+private:
+    void declare_emitters (modulus_t::module_context & ctx) override
+    {
+        ctx.declare_emitter(0, emitValue);
+    }
+
+    bool on_start () override
+    {
+        for (int i = 1; i <= 100; i++)
+            emitValue(i);
+
+        return true;
+    }
+};
+
+class consumer : public modulus_t::runnable_module
+{
+    int _sum = 0;
+
+private:
+    bool connect_detector (modulus_t::api_id_type id, modulus_t::module_context & ctx) override
+    {
+        switch (id) {
+            case 0:
+                return ctx.connect_detector(id, *this, & consumer::onValue);
+        }
+
+        return false;
+    }
+
+    void onValue (int value)
+    {
+        _sum += value;
+
+        if (_sum == 5050)
+            quit();
+    }
+
+public:
+    ~consumer ()
+    {
+        CHECK_EQ(_sum, 5050);
+    }
+};
+
+TEST_CASE("mpsc_function_queue as modulus function queue") {
+    using exit_status = modulus_t::exit_status;
+    modulus_t::dispatcher d{std::make_shared<modulus::iostream_logger>(), modulus::null_settings{}};
+
+    CHECK(d.register_module<producer>(std::make_pair("producer", "")));
+    CHECK(d.register_module<consumer>(std::make_pair("consumer", "")));
+    CHECK(d.exec() == exit_status::success);
+}
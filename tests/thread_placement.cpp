@@ -0,0 +1,58 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Vladislav Trifochkin
+//
+// License: see LICENSE file
+//
+// This file is part of `modulus2-lib`.
+//
+// Changelog:
+//      2026.10.17 Initial version.
+////////////////////////////////////////////////////////////////////////////////
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "pfs/modulus/thread_placement.hpp"
+#include <thread>
+
+TEST_CASE("parse_cpu_list") {
+    std::vector<int> cpus;
+
+    CHECK(modulus::parse_cpu_list("", cpus));
+    CHECK(cpus.empty());
+
+    CHECK(modulus::parse_cpu_list("3", cpus));
+    CHECK_EQ(cpus, std::vector<int>{3});
+
+    CHECK(modulus::parse_cpu_list("0-3,8,10-11\n", cpus));
+    CHECK_EQ(cpus, std::vector<int>{0, 1, 2, 3, 8, 10, 11});
+
+    CHECK_FALSE(modulus::parse_cpu_list("3-1", cpus));
+    CHECK_FALSE(modulus::parse_cpu_list("a", cpus));
+    CHECK_FALSE(modulus::parse_cpu_list("1;2", cpus));
+    CHECK_EQ(cpus, std::vector<int>{0, 1, 2, 3, 8, 10, 11});
+}
+
+#if MODULUS__THREAD_PLACEMENT_ENABLED
+TEST_CASE("apply_thread_placement") {
+    std::string error;
+
+    std::thread th {[& error] {
+        modulus::placement_options opts;
+        opts.cpu_set = {0};
+        error = modulus::apply_thread_placement(opts);
+    }};
+
+    th.join();
+
+    CHECK_MESSAGE(error.empty(), error);
+
+    std::thread th1 {[& error] {
+        modulus::placement_options opts;
+        opts.cpu_set = {-1};
+        error = modulus::apply_thread_placement(opts);
+    }};
+
+    th1.join();
+
+    CHECK_FALSE(error.empty());
+}
+#endif
@@ -0,0 +1,174 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Vladislav Trifochkin
+//
+// License: see LICENSE file
+//
+// This file is part of `modulus2-lib`.
+//
+// Changelog:
+//      2026.10.17 Initial version.
+//      2026.10.17 Added idle wakeups test.
+//      2026.10.17 Added resume of fixed-delay timer from its callback.
+////////////////////////////////////////////////////////////////////////////////
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "pfs/modulus/timing_wheel.hpp"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono;
+
+TEST_CASE("Single shot timers") {
+    modulus::timing_wheel<int> wheel;
+    std::atomic_int counter {0};
+
+    for (int i = 0; i < 100; i++)
+        CHECK_NE(wheel.create(milliseconds{i % 20}, [& counter] { ++counter; }), 0);
+
+    auto cancelled = wheel.create(milliseconds{30}, [& counter] { counter += 1000; });
+    wheel.destroy(cancelled);
+
+    std::this_thread::sleep_for(milliseconds{100});
+
+    CHECK_EQ(counter.load(), 100);
+    CHECK_EQ(wheel.count(), 0);
+}
+
+TEST_CASE("Cascading") {
+    // 1 microsecond resolution puts 100 ms delay on the third level
+    modulus::timing_wheel<int> wheel {microseconds{1}};
+    std::atomic_bool fired {false};
+    auto start = steady_clock::now();
+    steady_clock::time_point fired_at;
+
+    wheel.create(milliseconds{100}, [&] { fired_at = steady_clock::now(); fired = true; });
+
+    while (!fired && steady_clock::now() - start < seconds{2})
+        std::this_thread::sleep_for(milliseconds{5});
+
+    REQUIRE(fired);
+    CHECK(fired_at - start >= milliseconds{100});
+}
+
+TEST_CASE("Periodic timer") {
+    modulus::timing_wheel<int> wheel;
+    std::atomic_int counter {0};
+
+    auto id = wheel.create(milliseconds{5}, milliseconds{5}, [& counter] { ++counter; });
+
+    std::this_thread::sleep_for(milliseconds{100});
+    wheel.destroy(id);
+
+    auto n = counter.load();
+    CHECK(n >= 5);
+    CHECK(n <= 21);
+
+    std::this_thread::sleep_for(milliseconds{30});
+    CHECK(counter.load() <= n + 1);
+}
+
+TEST_CASE("Stale identifier") {
+    modulus::timing_wheel<int> wheel;
+    std::atomic_int counter {0};
+
+    auto id1 = wheel.create(milliseconds{1}, [& counter] { ++counter; });
+    std::this_thread::sleep_for(milliseconds{20});
+    REQUIRE_EQ(counter.load(), 1);
+
+    // Entry of the expired timer is reused
+    auto id2 = wheel.create(milliseconds{20}, [& counter] { ++counter; });
+    CHECK_NE(id1, id2);
+
+    wheel.destroy(id1);
+    std::this_thread::sleep_for(milliseconds{60});
+    CHECK_EQ(counter.load(), 2);
+}
+
+TEST_CASE("Dispatch") {
+    std::vector<int> targets;
+    int a = 1, b = 2;
+
+    {
+        modulus::timing_wheel<int> wheel {milliseconds{1}
+            , [& targets] (void * target, std::function<void()> &) {
+                targets.push_back(*static_cast<int *>(target));
+            }};
+
+        wheel.create(milliseconds{1}, milliseconds{0}, & a, [] {});
+        wheel.create(milliseconds{10}, milliseconds{0}, & b, [] {});
+        std::this_thread::sleep_for(milliseconds{50});
+    }
+
+    REQUIRE_EQ(targets.size(), 2);
+    CHECK_EQ(targets[0], 1);
+    CHECK_EQ(targets[1], 2);
+}
+
+TEST_CASE("Fixed delay timer") {
+    modulus::timing_wheel<int> wheel;
+    std::atomic_int counter {0};
+
+    auto id = wheel.create(milliseconds{1}, milliseconds{1}, modulus::timer_mode::fixed_delay
+        , nullptr, [& counter] { ++counter; });
+
+    // Suspended after the first expiration until resumed
+    std::this_thread::sleep_for(milliseconds{30});
+    CHECK_EQ(counter.load(), 1);
+
+    CHECK(wheel.resume(id));
+    std::this_thread::sleep_for(milliseconds{30});
+    CHECK_EQ(counter.load(), 2);
+
+    wheel.destroy(id);
+    CHECK_FALSE(wheel.resume(id));
+}
+
+TEST_CASE("Fixed delay timer resumed while firing") {
+    modulus::timing_wheel<int> wheel;
+    std::atomic_int counter {0};
+    std::atomic_int id {0};
+
+    // Callback is called directly from the wheel thread, so the timer is
+    // resumed before the dispatch finished
+    id = wheel.create(milliseconds{5}, milliseconds{1}, modulus::timer_mode::fixed_delay
+        , nullptr, [& wheel, & counter, & id] {
+            ++counter;
+            wheel.resume(id.load());
+        });
+
+    std::this_thread::sleep_for(milliseconds{50});
+    wheel.destroy(id.load());
+
+    CHECK_GT(counter.load(), 5);
+}
+
+TEST_CASE("Idle wakeups") {
+    modulus::timing_wheel<int> wheel {milliseconds{1}};
+    std::atomic_int counter {0};
+
+    // Long timer does not wake up the thread every tick
+    auto id = wheel.create(seconds{10}, [& counter] { ++counter; });
+    auto wakeups = wheel.wakeup_count();
+
+    std::this_thread::sleep_for(milliseconds{300});
+    CHECK_LE(wheel.wakeup_count() - wakeups, 5);
+
+    // Earlier timer armed while the thread is sleeping
+    auto start = steady_clock::now();
+    steady_clock::time_point fired_at;
+    std::atomic_bool fired {false};
+
+    wheel.create(milliseconds{20}, [&] { fired_at = steady_clock::now(); fired = true; });
+
+    while (!fired && steady_clock::now() - start < seconds{2})
+        std::this_thread::sleep_for(milliseconds{1});
+
+    REQUIRE(fired);
+    CHECK(fired_at - start >= milliseconds{20});
+    CHECK(fired_at - start < milliseconds{200});
+
+    wheel.destroy(id);
+    CHECK_EQ(counter.load(), 0);
+}